@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "mint.h"
+
+// coco: preserve_begin
+// Element-wise kernels over arrays of mint / static_mint<Mod>. With AVX2 they work on
+// 8 lanes at a time and multiply with Montgomery reduction (plain mint needs an odd
+// mod for that, otherwise it falls back to the scalar loop like every other type).
+namespace batch_detail {
+
+typedef unsigned u32;
+typedef unsigned long long u64;
+
+template<class T> struct traits { static constexpr bool simd = false; };
+template<> struct traits<mint> { static constexpr bool simd = true, mont = false; static inline u32 get_mod() { return mod; } };
+template<int Mod> struct traits<static_mint<Mod>> { static constexpr bool simd = true, mont = true; static inline u32 get_mod() { return Mod; } };
+
+#ifdef __AVX2__
+struct avx2 {
+	u32 mod, ninv, r2;
+	__m256i m, n, r;
+	explicit avx2(u32 mod): mod(mod), ninv(mod), r2(-(u64)mod % mod) {
+		for (int i = 0; i < 4; ++i) ninv *= 2 - mod * ninv;
+		ninv = -ninv;
+		m = _mm256_set1_epi32(mod); n = _mm256_set1_epi32(ninv); r = _mm256_set1_epi32(r2);
+	}
+	static inline __m256i load(const void *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+	static inline void store(void *p, __m256i x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+	inline __m256i add(__m256i x, __m256i y) const {
+		const __m256i s = _mm256_add_epi32(x, y);
+		return _mm256_min_epu32(s, _mm256_sub_epi32(s, m));
+	}
+	inline __m256i sub(__m256i x, __m256i y) const {
+		const __m256i d = _mm256_sub_epi32(x, y);
+		return _mm256_min_epu32(d, _mm256_add_epi32(d, m));
+	}
+	// x * y / 2^32 % mod for x, y < mod; even and odd lanes are reduced separately
+	inline __m256i mul(__m256i x, __m256i y) const {
+		const __m256i pe = _mm256_mul_epu32(x, y);
+		const __m256i po = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+		const __m256i te = _mm256_add_epi64(pe, _mm256_mul_epu32(_mm256_mul_epu32(pe, n), m));
+		const __m256i to = _mm256_add_epi64(po, _mm256_mul_epu32(_mm256_mul_epu32(po, n), m));
+		const __m256i t = _mm256_blend_epi32(_mm256_srli_epi64(te, 32), to, 0b10101010);
+		return _mm256_min_epu32(t, _mm256_sub_epi32(t, m));
+	}
+};
+#endif
+
+} // namespace batch_detail
+
+// dst[i] = a[i] + b[i]
+template<class T>
+inline void add_n(T *dst, const T *a, const T *b, size_t n) {
+	size_t i = 0;
+#ifdef __AVX2__
+	if constexpr (batch_detail::traits<T>::simd) {
+		const batch_detail::avx2 c(batch_detail::traits<T>::get_mod());
+		for (; i + 8 <= n; i += 8) c.store(dst + i, c.add(c.load(a + i), c.load(b + i)));
+	}
+#endif
+	for (; i < n; ++i) dst[i] = a[i] + b[i];
+}
+
+// dst[i] = a[i] - b[i]
+template<class T>
+inline void sub_n(T *dst, const T *a, const T *b, size_t n) {
+	size_t i = 0;
+#ifdef __AVX2__
+	if constexpr (batch_detail::traits<T>::simd) {
+		const batch_detail::avx2 c(batch_detail::traits<T>::get_mod());
+		for (; i + 8 <= n; i += 8) c.store(dst + i, c.sub(c.load(a + i), c.load(b + i)));
+	}
+#endif
+	for (; i < n; ++i) dst[i] = a[i] - b[i];
+}
+
+// dst[i] = a[i] * b[i]
+template<class T>
+inline void mul_n(T *dst, const T *a, const T *b, size_t n) {
+	size_t i = 0;
+#ifdef __AVX2__
+	typedef batch_detail::traits<T> tr;
+	if constexpr (tr::simd) if (tr::mont || (tr::get_mod() & 1)) {
+		const batch_detail::avx2 c(tr::get_mod());
+		for (; i + 8 <= n; i += 8) {
+			__m256i x = c.mul(c.load(a + i), c.load(b + i));
+			if constexpr (!tr::mont) x = c.mul(x, c.r);
+			c.store(dst + i, x);
+		}
+	}
+#endif
+	for (; i < n; ++i) dst[i] = a[i] * b[i];
+}
+
+// y[i] += k * x[i]
+template<class T>
+inline void axpy(T *y, const T &k, const T *x, size_t n) {
+	size_t i = 0;
+#ifdef __AVX2__
+	typedef batch_detail::traits<T> tr;
+	if constexpr (tr::simd) if (tr::mont || (tr::get_mod() & 1)) {
+		const batch_detail::avx2 c(tr::get_mod());
+		// a plain multiplier is moved into Montgomery form once so one reduction per lane suffices
+		const __m256i kk = _mm256_set1_epi32(tr::mont? k.v: ((batch_detail::u64)k.v << 32) % c.mod);
+		for (; i + 8 <= n; i += 8) c.store(y + i, c.add(c.load(y + i), c.mul(kk, c.load(x + i))));
+	}
+#endif
+	for (; i < n; ++i) y[i] += k * x[i];
+}
+// coco: preserve_end
@@ -0,0 +1,262 @@
+// Throughput of io.h against scanf, iostream and getchar_unlocked.
+//
+//   g++ -O2 -march=native bench/io.cpp -o bench_io && ./bench_io [values]
+//   g++ -O2 -march=native -DMIVIK bench/io.cpp -o bench_io_mivik && ./bench_io_mivik [values]
+//
+// The second build only times MI in fgetc mode. Every result line is
+// "<shape>\t<method>\t<MB/s>\t<ns/value>", so runs of different commits can be
+// joined on the first two columns.
+#define MO_COUT
+#include "../io.h"
+#include "../random.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+using u64 = unsigned long long;
+
+const int REPEAT = 3;
+const u64 SEED = 0x658c382b;
+
+enum value_type { INT, LL, STR };
+
+struct shape {
+	std::string name;
+	value_type type;
+	size_t count;
+	std::function<void(MO&, mic::random_engine<std::mt19937_64>&)> gen;
+};
+
+struct method {
+	std::string name;
+	std::function<u64(value_type, size_t)> run;
+};
+
+inline u64 mix(u64 h, u64 v) { return h * 1000003 + v; }
+inline u64 mix(u64 h, const char *s, size_t n) { return mix(mix(h, n), n? (unsigned char)s[0]: 0); }
+
+template<class T>
+inline bool read_gc(T &r) {
+	int c = getchar_unlocked();
+	while (c != '-' && (c < '0' || c > '9')) {
+		if (c == EOF) return false;
+		c = getchar_unlocked();
+	}
+	bool neg = c == '-';
+	if (neg) c = getchar_unlocked();
+	r = 0;
+	for (; c >= '0' && c <= '9'; c = getchar_unlocked()) r = r * 10 + (c ^ 48);
+	if (neg) r = -r;
+	return true;
+}
+
+inline size_t read_gc(char *s) {
+	int c = getchar_unlocked();
+	while (c != EOF && c <= ' ') c = getchar_unlocked();
+	size_t n = 0;
+	for (; c != EOF && c > ' '; c = getchar_unlocked()) s[n++] = c;
+	return n;
+}
+
+template<class F>
+u64 with_type(value_type type, size_t count, F &&f) {
+	u64 h = 0;
+	switch (type) {
+		case INT: { int x; for (size_t i = 0; i < count; ++i) h = mix(h, f(x)); break; }
+		case LL: { long long x; for (size_t i = 0; i < count; ++i) h = mix(h, f(x)); break; }
+		case STR: { std::string x; for (size_t i = 0; i < count; ++i) { f(x); h = mix(h, x.data(), x.size()); } break; }
+	}
+	return h;
+}
+
+std::vector<method> input_methods() {
+	std::vector<method> ret;
+#ifdef MIVIK
+	ret.push_back({ "MI-fgetc", [](value_type type, size_t count) {
+		MI in(stdin);
+		return with_type(type, count, [&](auto &x) {
+			in > x;
+			if constexpr (std::is_same_v<std::decay_t<decltype(x)>, std::string>) return 0ULL;
+			else return (u64)x;
+		});
+	} });
+#else
+	const auto mi = [](bool map) {
+		return [map](value_type type, size_t count) {
+			MI in(stdin, map);
+			return with_type(type, count, [&](auto &x) {
+				in > x;
+				if constexpr (std::is_same_v<std::decay_t<decltype(x)>, std::string>) return 0ULL;
+				else return (u64)x;
+			});
+		};
+	};
+	ret.push_back({ "MI", mi(false) });
+	ret.push_back({ "MI-mmap", mi(true) });
+	ret.push_back({ "MI-read_n", [](value_type type, size_t count) {
+		MI in(stdin, true);
+		u64 h = 0;
+		const auto bulk = [&](auto tag) {
+			std::vector<decltype(tag)> arr; in.read_n(arr, count);
+			for (auto x : arr) h = mix(h, x);
+		};
+		if (type == INT) bulk(int());
+		else if (type == LL) bulk((long long)0);
+		else {
+			std::vector<std::string> arr; in.read_n(arr, count);
+			for (auto &x : arr) h = mix(h, x.data(), x.size());
+		}
+		return h;
+	} });
+	ret.push_back({ "scanf", [](value_type type, size_t count) {
+		u64 h = 0;
+		switch (type) {
+			case INT: for (int x; count--; ) { if (scanf("%d", &x) != 1) break; h = mix(h, x); } break;
+			case LL: for (long long x; count--; ) { if (scanf("%lld", &x) != 1) break; h = mix(h, x); } break;
+			case STR: {
+				static char s[1 << 16];
+				for (; count--; ) { if (scanf("%s", s) != 1) break; h = mix(h, s, strlen(s)); }
+				break;
+			}
+		}
+		return h;
+	} });
+	ret.push_back({ "iostream", [](value_type type, size_t count) {
+		std::cin.clear();
+		return with_type(type, count, [](auto &x) {
+			std::cin >> x;
+			if constexpr (std::is_same_v<std::decay_t<decltype(x)>, std::string>) return 0ULL;
+			else return (u64)x;
+		});
+	} });
+	ret.push_back({ "getchar_unlocked", [](value_type type, size_t count) {
+		u64 h = 0;
+		switch (type) {
+			case INT: for (int x; count-- && read_gc(x); ) h = mix(h, x); break;
+			case LL: for (long long x; count-- && read_gc(x); ) h = mix(h, x); break;
+			case STR: {
+				static char s[1 << 16];
+				for (size_t n; count-- && (n = read_gc(s)); ) h = mix(h, s, n);
+				break;
+			}
+		}
+		return h;
+	} });
+#endif
+	return ret;
+}
+
+std::vector<method> output_methods(const std::string &path) {
+	std::vector<method> ret;
+#ifndef MIVIK
+	const auto values = [](auto f) {
+		return [f](value_type type, size_t count) {
+			mic::random_engine<std::mt19937_64> e(SEED);
+			if (type == INT) for (size_t i = 0; i < count; ++i) f(e.rand<int>());
+			else for (size_t i = 0; i < count; ++i) f(e.rand<long long>());
+			return (u64)count;
+		};
+	};
+	ret.push_back({ "MO", [=](value_type type, size_t count) {
+		FILE *f = fopen(path.data(), "w");
+		u64 ret;
+		{
+			MO out(f);
+			ret = values([&](auto x) { out < x < ' '; })(type, count);
+		}
+		fclose(f);
+		return ret;
+	} });
+	ret.push_back({ "printf", [=](value_type type, size_t count) {
+		FILE *f = fopen(path.data(), "w");
+		const u64 ret = values([&](auto x) {
+			if constexpr (std::is_same_v<decltype(x), int>) fprintf(f, "%d ", x);
+			else fprintf(f, "%lld ", x);
+		})(type, count);
+		fclose(f);
+		return ret;
+	} });
+	ret.push_back({ "iostream", [=](value_type type, size_t count) {
+		std::ofstream out(path);
+		return values([&](auto x) { out << x << ' '; })(type, count);
+	} });
+#endif
+	return ret;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	std::ios::sync_with_stdio(false);
+	const size_t n = argc > 1? std::stoull(argv[1]): 2000000;
+	const auto dir = std::filesystem::temp_directory_path();
+	const std::string in_path = dir / "mic_bench_io.in", out_path = dir / "mic_bench_io.out";
+
+	std::vector<shape> shapes = {
+		{ "small", INT, n, [](MO &out, auto &e) { out < e(0, 1000) < ' '; } },
+		{ "int64", LL, n, [](MO &out, auto &e) { out < e.template rand<long long>() < ' '; } },
+		{ "negative", INT, n, [](MO &out, auto &e) { out < e(-1000000000, -1) < '\n'; } },
+		{ "long_token", STR, n / 10, [](MO &out, auto &e) {
+			for (int len = e(20, 200); len--; ) out < (char)e('a', 'z');
+			out < '\n';
+		} },
+		{ "mixed_ws", INT, n, [](MO &out, auto &e) {
+			static const char *ws[] = { " ", "  ", "\t", "\n", "\r\n", " \t \n" };
+			out < e(-1000000, 1000000) < ws[e(0, 5)];
+		} },
+	};
+
+	const auto time = [](auto &&f) {
+		double best = 1e100;
+		u64 ret = 0;
+		for (int i = 0; i < REPEAT; ++i) {
+			const auto start = std::chrono::steady_clock::now();
+			ret = f();
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		return std::make_pair(best, ret);
+	};
+	const auto report = [](const std::string &shape, const std::string &name, double bytes, size_t count, double sec) {
+		printf("%s\t%s\t%.1f\t%.2f\n", shape.data(), name.data(), bytes / sec / 1e6, sec * 1e9 / count);
+		fflush(stdout);
+	};
+
+	printf("shape\tmethod\tMB/s\tns/value\n");
+	const auto inputs = input_methods();
+	for (auto &s : shapes) {
+		{
+			FILE *f = fopen(in_path.data(), "w");
+			{
+				MO out(f);
+				mic::random_engine<std::mt19937_64> e(SEED);
+				for (size_t i = 0; i < s.count; ++i) s.gen(out, e);
+			}
+			fclose(f);
+		}
+		const double bytes = std::filesystem::file_size(in_path);
+		u64 expected = 0;
+		bool first = true;
+		for (auto &m : inputs) {
+			const auto [sec, h] = time([&] {
+				if (!freopen(in_path.data(), "r", stdin)) exit(1);
+				return m.run(s.type, s.count);
+			});
+			if (first) expected = h, first = false;
+			else if (h != expected) fprintf(stderr, "%s/%s: checksum mismatch\n", s.name.data(), m.name.data());
+			report(s.name, m.name, bytes, s.count, sec);
+		}
+	}
+	for (auto &m : output_methods(out_path))
+		for (auto type : { INT, LL }) {
+			const auto [sec, cnt] = time([&] { return m.run(type, n); });
+			report(type == INT? "int_out": "int64_out", m.name, std::filesystem::file_size(out_path), cnt, sec);
+		}
+	std::filesystem::remove(in_path);
+	std::filesystem::remove(out_path);
+}
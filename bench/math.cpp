@@ -0,0 +1,122 @@
+// Latency and throughput of the modular types in math.h / mint.h.
+//
+//   g++ -O2 -march=native bench/math.cpp -o bench_math && ./bench_math [runtime prime]
+//
+// mint and static_mint use the compile-time prime 998244353; dynamic_mint uses the
+// runtime prime (998244353 unless given), mint64 and mint61 both use 2^61 - 1.
+// "chain" feeds every result into the next operation (latency), "stream" runs
+// independent operations over arrays (throughput). "dot_naive" is the plain
+// s += a[i] * b[i] loop and "dot_lazy" is dot() from mint.h, both timed per term
+// over the same arrays and reported as "stream". Every result line is
+// "<type>\t<op>\t<mode>\t<ns/op>", so runs of different commits can be joined on
+// the first three columns.
+#include "../mint.h"
+#include "../random.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+const int mod = 998244353;
+
+namespace {
+
+using u64 = unsigned long long;
+
+const int REPEAT = 3;
+const u64 SEED = 0x658c382b;
+const size_t ARRAY = 4096;
+const qe EXPONENT = 1000000007;
+
+struct runtime_tag;
+struct mersenne_tag;
+
+template<class T>
+inline void keep(const T &x) { asm volatile("" : : "g"(&x) : "memory"); }
+
+template<class F>
+double best_ns(size_t ops, F &&f) {
+	double best = 1e100;
+	for (int i = 0; i < REPEAT; ++i) {
+		const auto start = std::chrono::steady_clock::now();
+		f();
+		best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
+	return best * 1e9 / ops;
+}
+
+inline void report(const char *type, const char *op, const char *mode, double ns) {
+	printf("%s\t%s\t%s\t%.3f\n", type, op, mode, ns);
+	fflush(stdout);
+}
+
+// mint has no pow(); time math.h's ksm for it
+template<class T> inline T power(const T &x, qe p) { return x.pow(p); }
+template<> inline mint power(const mint &x, qe p) { return ksm(x.v, p); }
+
+template<class T, class Make>
+void run(const char *type, Make make) {
+	mic::random_engine<std::mt19937_64> e(SEED);
+	std::vector<T> a(ARRAY), b(ARRAY), c(ARRAY);
+	for (auto &x : a) x = make(e.template rand<u64>() | 1);
+	for (auto &x : b) x = make(e.template rand<u64>() | 1);
+	const T y = b[0];
+
+	const auto chain = [&](const char *op, size_t n, auto f) {
+		report(type, op, "chain", best_ns(n, [&] {
+			T x = a[0];
+			for (size_t i = 0; i < n; ++i) x = f(x, y);
+			keep(x);
+		}));
+	};
+	const auto stream = [&](const char *op, size_t rounds, auto f) {
+		report(type, op, "stream", best_ns(rounds * ARRAY, [&] {
+			for (size_t r = 0; r < rounds; ++r) {
+				for (size_t i = 0; i < ARRAY; ++i) c[i] = f(a[i], b[i]);
+				keep(c[0]);
+			}
+		}));
+	};
+
+	const auto add = [](const T &x, const T &y) { return x + y; };
+	const auto sub = [](const T &x, const T &y) { return x - y; };
+	const auto mul = [](const T &x, const T &y) { return x * y; };
+	const auto inv = [](const T &x, const T &) { return x.inv(); };
+	const auto pow = [](const T &x, const T &) { return power(x, EXPONENT); };
+	chain("add", 20000000, add); stream("add", 5000, add);
+	chain("sub", 20000000, sub); stream("sub", 5000, sub);
+	chain("mul", 20000000, mul); stream("mul", 5000, mul);
+	chain("inv", 100000, inv); stream("inv", 25, inv);
+	chain("pow", 100000, pow); stream("pow", 25, pow);
+
+	// dot products: one reduction per term against lazy_sum
+	const size_t rounds = 5000;
+	report(type, "dot_naive", "stream", best_ns(rounds * ARRAY, [&] {
+		for (size_t r = 0; r < rounds; ++r) {
+			T s = T(0);
+			for (size_t i = 0; i < ARRAY; ++i) s += a[i] * b[i];
+			keep(s);
+		}
+	}));
+	report(type, "dot_lazy", "stream", best_ns(rounds * ARRAY, [&] {
+		for (size_t r = 0; r < rounds; ++r) {
+			T s = dot(a.data(), b.data(), ARRAY);
+			keep(s);
+		}
+	}));
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+	const int p = argc > 1? std::stoi(argv[1]): 998244353;
+	dynamic_mint<runtime_tag>::set_mod(p);
+	mint64<mersenne_tag>::set_mod(mint61::M);
+
+	printf("type\top\tmode\tns/op\n");
+	run<mint>("mint", [](u64 x) { return mint((int)(x % mod)); });
+	run<static_mint<998244353>>("static_mint", [](u64 x) { return static_mint<998244353>((int)(x % 998244353)); });
+	run<dynamic_mint<runtime_tag>>("dynamic_mint", [p](u64 x) { return dynamic_mint<runtime_tag>((int)(x % p)); });
+	run<mint64<mersenne_tag>>("mint64", [](u64 x) { return mint64<mersenne_tag>((qe)(x >> 3)); });
+	run<mint61>("mint61", [](u64 x) { return mint61((qe)(x >> 3)); });
+}
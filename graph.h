@@ -3,24 +3,102 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace mic {
 namespace graph {
 
+namespace detail {
+
+// Counting-sort placement of an edge list of (u, v[, info]) tuples, shared by the
+// bulk builders. alloc(deg) receives the final degree of every node; then
+// put(x, i, y, e) is called once per arc x -> y, i being its index among the arcs of
+// x in link() order, e the edge it comes from. The edges are cut into `threads`
+// chunks that are counted and placed in parallel (0 picks a count by input size).
+// Every chunk keeps n counters, so the thread count is also capped to keep them
+// within the size of the edge list itself (or 64 MiB, whichever is larger).
+template<bool directed, class E, class Alloc, class Put>
+void place_edges(size_t n, const std::vector<E> &edges, unsigned threads, Alloc &&alloc, Put &&put) {
+	constexpr size_t CHUNK = 1 << 20, MIN_BUDGET = 1 << 26;
+	const size_t m = edges.size();
+	if (!threads) threads = m >= (CHUNK << 2)? std::max(1u, std::thread::hardware_concurrency()): 1;
+	threads = std::max<size_t>(1, std::min<size_t>(threads, m / CHUNK));
+	const size_t budget = std::max(MIN_BUDGET, m * sizeof(E));
+	threads = std::max<size_t>(1, std::min<size_t>(threads, budget / (std::max<size_t>(n, 1) * sizeof(size_t))));
+	const auto run = [threads](auto &&func) {
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads; ++i) pool.emplace_back(func, i);
+		func(0);
+		for (auto &t : pool) t.join();
+	};
+	// cnt[t * n + x]: arcs of x in chunk t, then where chunk t starts writing them
+	std::vector<size_t> cnt((size_t)threads * n), deg(n);
+	run([&](unsigned t) {
+		size_t *c = cnt.data() + (size_t)t * n;
+		for (size_t i = m / threads * t, e = t + 1 == threads? m: m / threads * (t + 1); i < e; ++i) {
+			const size_t x = std::get<0>(edges[i]), y = std::get<1>(edges[i]);
+			++c[x];
+			if (!directed && x != y) ++c[y];
+		}
+	});
+	run([&](unsigned t) {
+		for (size_t x = n / threads * t, e = t + 1 == threads? n: n / threads * (t + 1); x < e; ++x) {
+			size_t s = 0;
+			for (unsigned k = 0; k < threads; ++k) s += std::exchange(cnt[(size_t)k * n + x], s);
+			deg[x] = s;
+		}
+	});
+	alloc(deg);
+	run([&](unsigned t) {
+		size_t *c = cnt.data() + (size_t)t * n;
+		for (size_t i = m / threads * t, e = t + 1 == threads? m: m / threads * (t + 1); i < e; ++i) {
+			const size_t x = std::get<0>(edges[i]), y = std::get<1>(edges[i]);
+			put(x, c[x]++, y, edges[i]);
+			if (!directed && x != y) put(y, c[y]++, x, edges[i]);
+		}
+	});
+}
+
+} // namespace detail
+
 template<class edge_info, bool directed = false>
 struct base_graph {
 #define for_info template<bool local = has_info, std::enable_if_t<local, int> = 0>
 #define for_no_info template<bool local = has_info, std::enable_if_t<!local, int> = 0>
 
 	static constexpr bool has_info = !std::is_void_v<edge_info>;
+	static constexpr bool is_directed = directed;
 	using edge_type = std::conditional_t<has_info, std::pair<size_t, edge_info>, size_t>;
 	using node_t = size_t;
+	static inline node_t target(const edge_type &e) {
+		if constexpr (has_info) return e.first;
+		else return e;
+	}
+	// the input of the bulk builders: (u, v) or (u, v, info)
+	using edge_list_type = std::conditional_t<has_info,
+		std::vector<std::tuple<node_t, node_t, std::conditional_t<has_info, edge_info, char>>>,
+		std::vector<std::pair<node_t, node_t>>>;
 private:
 	template<class T>
-	struct empty_string_helper { inline std::string operator()(const T &t) { return ""; } };
+	struct empty_string_helper { template<class U> inline std::string operator()(const U &) { return ""; } };
 protected:
 	std::vector<std::vector<edge_type>> arr;
 public:
@@ -46,30 +124,281 @@ public:
 		arr[x].push_back(y);
 		if (!directed && x != y) arr[y].push_back(x);
 	}
+	// Same as resize(n) and then link() on every edge in order, but every adjacency
+	// list is sized once from the degree counts instead of growing edge by edge.
+	void assign(size_t n, const edge_list_type &edges, unsigned threads = 0) {
+		resize(n);
+		detail::place_edges<directed>(n, edges, threads,
+			[this](const std::vector<size_t> &deg) { for (node_t i = 0; i < deg.size(); ++i) arr[i].resize(deg[i]); },
+			[this](node_t x, size_t i, node_t y, const auto &e) {
+				if constexpr (has_info) arr[x][i] = { y, std::get<2>(e) };
+				else arr[x][i] = y;
+			});
+	}
+	// Writes the graph in DOT straight to `out`. Directed graphs list every arc,
+	// undirected ones each edge once (from its smaller endpoint).
 	template<class string_helper = empty_string_helper<edge_info>>
-	std::string to_dot() const {
-		const std::string dash = directed? " -> ": " -- ";
-		std::string ret = directed? "digraph {": "graph {";
-		const auto add = [&ret](const std::string &t) { ret += "\n  "; ret += t; };
+	void write_dot(std::ostream &out) const {
+		const char *dash = directed? " -> ": " -- ";
+		out << (directed? "digraph {": "graph {");
 		const size_t n = arr.size();
 		string_helper helper;
 		for (node_t i = 0; i < n; ++i) {
 			if constexpr (has_info) {
 				for (const auto &[v, info] : arr[i])
-					if (v >= i) add(std::to_string(i) + dash + std::to_string(v) + " [label=\"" + helper(info) + "\"]");
+					if (directed || v >= i) out << "\n  " << i << dash << v << " [label=\"" << helper(info) << "\"]";
 			} else {
 				for (auto v : arr[i])
-					if (v >= i) add(std::to_string(i) + dash + std::to_string(v));
+					if (directed || v >= i) out << "\n  " << i << dash << v;
 			}
 		}
-		ret += "\n}";
-		return ret;
+		out << "\n}";
+	}
+	template<class string_helper = empty_string_helper<edge_info>>
+	std::string to_dot() const {
+		std::ostringstream out;
+		write_dot<string_helper>(out);
+		return out.str();
 	}
 
 #undef for_info
 #undef for_no_info
 };
 
+// An immutable graph in compressed sparse row form: the targets of every node are
+// packed into one array (and their infos into a parallel one), indexed by offsets.
+// edges(node) iterates like base_graph::edges, yielding node_t or (node_t, edge_info).
+template<class edge_info, bool directed = false>
+struct csr_graph {
+	static constexpr bool has_info = !std::is_void_v<edge_info>;
+	static constexpr bool is_directed = directed;
+	using edge_type = std::conditional_t<has_info, std::pair<size_t, edge_info>, size_t>;
+	using node_t = size_t;
+	using info_t = std::conditional_t<has_info, edge_info, char>;
+	static inline node_t target(const edge_type &e) {
+		if constexpr (has_info) return e.first;
+		else return e;
+	}
+	using edge_list_type = typename base_graph<edge_info, directed>::edge_list_type;
+
+	// a forward iterator yielding edges by value; operator-> goes through a proxy
+	struct iterator {
+		struct arrow {
+			edge_type e;
+			inline const edge_type* operator->() const { return &e; }
+		};
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = edge_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = arrow;
+		using reference = edge_type;
+		const node_t *to;
+		const info_t *info;
+		inline edge_type operator*() const {
+			if constexpr (has_info) return { *to, *info };
+			else return *to;
+		}
+		inline arrow operator->() const { return { **this }; }
+		inline iterator& operator++() { ++to; if constexpr (has_info) ++info; return *this; }
+		inline iterator operator++(int) { iterator t = *this; ++*this; return t; }
+		inline bool operator==(const iterator &t) const { return to == t.to; }
+		inline bool operator!=(const iterator &t) const { return to != t.to; }
+	};
+	struct edge_range {
+		iterator b, e;
+		inline iterator begin() const { return b; }
+		inline iterator end() const { return e; }
+		inline size_t size() const { return e.to - b.to; }
+		inline bool empty() const { return b.to == e.to; }
+		inline edge_type operator[](size_t i) const { return *iterator{ b.to + i, has_info? b.info + i: nullptr }; }
+	};
+protected:
+	std::vector<size_t> off;
+	std::vector<node_t> to;
+	std::vector<info_t> info;
+public:
+	csr_graph(): off(1, 0) {}
+	csr_graph(const base_graph<edge_info, directed> &g): off(g.size() + 1, 0) {
+		const size_t n = g.size();
+		for (node_t i = 0; i < n; ++i) off[i + 1] = off[i] + g.edges(i).size();
+		to.resize(off[n]);
+		if constexpr (has_info) info.resize(off[n]);
+		for (node_t i = 0; i < n; ++i) {
+			size_t k = off[i];
+			if constexpr (has_info) {
+				for (const auto &[v, w] : g.edges(i)) to[k] = v, info[k++] = w;
+			} else std::copy(g.edges(i).begin(), g.edges(i).end(), to.begin() + k);
+		}
+	}
+	// Links the edges in order, like base_graph::assign.
+	static csr_graph from_edges(size_t n, const edge_list_type &edges, unsigned threads = 0) {
+		csr_graph ret;
+		detail::place_edges<directed>(n, edges, threads,
+			[&ret](const std::vector<size_t> &deg) {
+				ret.off.assign(deg.size() + 1, 0);
+				for (node_t i = 0; i < deg.size(); ++i) ret.off[i + 1] = ret.off[i] + deg[i];
+				ret.to.resize(ret.off.back());
+				if constexpr (has_info) ret.info.resize(ret.off.back());
+			},
+			[&ret](node_t x, size_t i, node_t y, const auto &e) {
+				ret.to[ret.off[x] + i] = y;
+				if constexpr (has_info) ret.info[ret.off[x] + i] = std::get<2>(e);
+			});
+		return ret;
+	}
+
+	inline size_t size() const { return off.size() - 1; }
+	inline bool empty() const { return off.size() == 1; }
+	// number of stored arcs (each undirected edge counts twice, self-loops once)
+	inline size_t arcs() const { return to.size(); }
+	inline size_t degree(node_t node) const { return off[node + 1] - off[node]; }
+	inline edge_range edges(node_t node) const {
+		const info_t *p = has_info? info.data(): nullptr;
+		return { { to.data() + off[node], has_info? p + off[node]: nullptr },
+			{ to.data() + off[node + 1], has_info? p + off[node + 1]: nullptr } };
+	}
+	inline std::vector<node_t> adjacents(node_t node) const {
+		return std::vector<node_t>(to.begin() + off[node], to.begin() + off[node + 1]);
+	}
+	inline const std::vector<size_t>& offsets() const { return off; }
+	inline const std::vector<node_t>& targets() const { return to; }
+	// empty unless has_info
+	inline const std::vector<info_t>& infos() const { return info; }
+
+	// Writes the binary form csr_view::open maps back: a binary_header, then the
+	// offsets, targets and (if has_info) infos, each padded to 8 bytes. edge_info
+	// must be trivially copyable; the file is only readable on the same platform.
+	bool save(const std::string &path) const {
+		static_assert(!has_info || std::is_trivially_copyable_v<info_t>, "edge_info must be trivially copyable");
+		FILE *f = fopen(path.data(), "wb");
+		if (!f) return false;
+		const binary_header h = binary_header::make(size(), arcs());
+		static const char zero[8] = {};
+		const auto put = [f](const void *p, size_t len) {
+			return fwrite(p, 1, len, f) == len && fwrite(zero, 1, -len & 7, f) == (-len & 7);
+		};
+		bool ok = put(&h, sizeof h) && put(off.data(), off.size() * sizeof(size_t)) && put(to.data(), to.size() * sizeof(node_t));
+		if constexpr (has_info) ok = ok && put(info.data(), info.size() * sizeof(info_t));
+		return fclose(f) == 0 && ok;
+	}
+
+	struct binary_header {
+		char magic[4];
+		uint32_t version, flags, info_size;
+		uint64_t n, arcs;
+		static binary_header make(uint64_t n, uint64_t arcs) {
+			return { { 'M', 'I', 'C', 'G' }, 1, directed | has_info << 1 | (uint32_t)sizeof(size_t) << 8,
+				has_info? (uint32_t)sizeof(info_t): 0, n, arcs };
+		}
+	};
+};
+
+// A read-only csr_graph over a file written by csr_graph::save. The file is mapped
+// (read into memory where mmap is not available), so opening does no parsing; the
+// view has the same size / degree / edges interface as csr_graph.
+template<class edge_info, bool directed = false>
+struct csr_view {
+	using graph_type = csr_graph<edge_info, directed>;
+	static constexpr bool has_info = graph_type::has_info;
+	static constexpr bool is_directed = directed;
+	using edge_type = typename graph_type::edge_type;
+	using node_t = size_t;
+	using info_t = typename graph_type::info_t;
+	using edge_range = typename graph_type::edge_range;
+	static inline node_t target(const edge_type &e) { return graph_type::target(e); }
+private:
+	const size_t *off = nullptr;
+	const node_t *to = nullptr;
+	const info_t *info = nullptr;
+	size_t n = 0;
+	void *map = nullptr;
+	size_t map_size = 0;
+	std::vector<uint64_t> buf;
+public:
+	csr_view() {}
+	csr_view(const csr_view&) = delete;
+	csr_view(csr_view &&t) { *this = std::move(t); }
+	csr_view& operator=(csr_view &&t) {
+		if (this != &t) {
+			close();
+			off = t.off; to = t.to; info = t.info; n = t.n;
+			map = std::exchange(t.map, nullptr); map_size = t.map_size;
+			buf = std::move(t.buf);
+			t.off = nullptr; t.n = 0;
+		}
+		return *this;
+	}
+	~csr_view() { close(); }
+
+	// false if the file can't be read, was not saved by a csr_graph<edge_info, directed>
+	// or has inconsistent sizes or offsets (targets are not checked)
+	bool open(const std::string &path) {
+		close();
+		FILE *f = fopen(path.data(), "rb");
+		if (!f) return false;
+		const char *data = nullptr;
+		size_t len = 0;
+#ifdef __linux__
+		struct stat st;
+		if (!fstat(fileno(f), &st) && S_ISREG(st.st_mode) && st.st_size > 0) {
+			void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fileno(f), 0);
+			if (p != MAP_FAILED) map = p, map_size = len = st.st_size, data = static_cast<const char*>(p);
+		}
+#endif
+		if (!data) {
+			std::vector<char> tmp;
+			char chunk[1 << 16];
+			for (size_t got; (got = fread(chunk, 1, sizeof chunk, f)); ) tmp.insert(tmp.end(), chunk, chunk + got);
+			buf.resize((tmp.size() + 7) >> 3);
+			std::copy(tmp.begin(), tmp.end(), reinterpret_cast<char*>(buf.data()));
+			data = reinterpret_cast<const char*>(buf.data()); len = tmp.size();
+		}
+		fclose(f);
+		using header = typename graph_type::binary_header;
+		const auto pad = [](size_t x) { return (x + 7) & ~(size_t)7; };
+		const header expect = header::make(0, 0);
+		if (len < sizeof(header)) return close(), false;
+		header h;
+		std::copy(data, data + sizeof h, reinterpret_cast<char*>(&h));
+		if (!std::equal(h.magic, h.magic + 4, expect.magic) || h.version != expect.version || h.flags != expect.flags
+			|| h.info_size != expect.info_size) return close(), false;
+		// no array may be longer than the file, which also keeps the sizes below from overflowing
+		if (h.n >= len / sizeof(size_t) || h.arcs > len / sizeof(node_t) || (has_info && h.arcs > len / sizeof(info_t)))
+			return close(), false;
+		const size_t need = pad(sizeof h) + pad((h.n + 1) * sizeof(size_t)) + pad(h.arcs * sizeof(node_t))
+			+ (has_info? pad(h.arcs * sizeof(info_t)): 0);
+		if (len < need) return close(), false;
+		const size_t *o = reinterpret_cast<const size_t*>(data + pad(sizeof h));
+		if (o[0] || o[h.n] != h.arcs) return close(), false;
+		for (size_t i = 0; i < h.n; ++i)
+			if (o[i] > o[i + 1]) return close(), false;
+		n = h.n;
+		off = o;
+		to = reinterpret_cast<const node_t*>(reinterpret_cast<const char*>(off) + pad((n + 1) * sizeof(size_t)));
+		if constexpr (has_info) info = reinterpret_cast<const info_t*>(reinterpret_cast<const char*>(to) + pad(h.arcs * sizeof(node_t)));
+		return true;
+	}
+	void close() {
+#ifdef __linux__
+		if (map) munmap(map, map_size);
+#endif
+		map = nullptr;
+		buf.clear(); buf.shrink_to_fit();
+		off = nullptr; to = nullptr; info = nullptr; n = 0;
+	}
+	inline bool is_open() const { return off; }
+
+	inline size_t size() const { return n; }
+	inline bool empty() const { return !n; }
+	inline size_t arcs() const { return off? off[n]: 0; }
+	inline size_t degree(node_t node) const { return off[node + 1] - off[node]; }
+	inline edge_range edges(node_t node) const {
+		return { { to + off[node], has_info? info + off[node]: nullptr },
+			{ to + off[node + 1], has_info? info + off[node + 1]: nullptr } };
+	}
+	inline std::vector<node_t> adjacents(node_t node) const { return std::vector<node_t>(to + off[node], to + off[node + 1]); }
+};
+
 template<class V = int> struct directed_weighted_graph;
 struct directed_graph;
 template<class V = int> struct undirected_weighted_graph;
@@ -110,40 +439,64 @@ struct undirected_graph : public undirected_weighted_graph<void> {
 template<class V>
 struct weighted_tree : public undirected_weighted_graph<V> {
 	using typename undirected_weighted_graph<V>::node_t;
-private:
-	void get_dfs_sequence(node_t x, node_t f, node_t *dst) const {
-		*dst++ = x;
-		if constexpr (base_graph<V, false>::has_info) {
-			for (const auto &[v, _] : this->edges(x))
-				if (v != f) get_dfs_sequence(v, x, dst);
-		} else {
-			for (auto v : this->edges(x))
-				if (v != f) get_dfs_sequence(v, x, dst);
+	using base = base_graph<V, false>;
+	// Everything one walk from a root gives: parent (-1 for the root), depth in
+	// edges, the DFS preorder and subtree sizes.
+	struct traversal {
+		std::vector<node_t> parent, depth, order, size;
+	};
+	// All of these use an explicit stack, so paths of any length are fine. Children
+	// are visited in the order of edges(x).
+	void get_dfs_sequence(node_t root, node_t *dst) const {
+		std::vector<std::pair<node_t, node_t>> stack{ { root, -1 } };
+		while (!stack.empty()) {
+			const auto [x, f] = stack.back(); stack.pop_back();
+			*dst++ = x;
+			const auto &e = this->edges(x);
+			for (size_t i = e.size(); i--; )
+				if (base::target(e[i]) != f) stack.emplace_back(base::target(e[i]), x);
 		}
 	}
-	void get_parents(node_t x, node_t f, node_t *dst) const {
-		dst[x] = f;
-		if constexpr (base_graph<V, false>::has_info) {
-			for (const auto &[v, _] : this->edges(x))
-				if (v != f) get_parents(v, x, dst);
-		} else {
-			for (auto v : this->edges(x))
-				if (v != f) get_parents(v, x, dst);
-		}
-	}
-public:
-	void get_dfs_sequence(node_t root, node_t *dst) const { get_dfs_sequence(root, -1, dst); }
 	std::vector<node_t> dfs_sequence(node_t root) const {
 		std::vector<node_t> ret; ret.resize(this->size());
 		get_dfs_sequence(root, ret.data());
 		return ret;
 	}
-	void get_parents(node_t root, node_t *dst) const { get_parents(root, -1, dst); }
+	void get_parents(node_t root, node_t *dst) const {
+		std::vector<node_t> stack{ root };
+		dst[root] = -1;
+		while (!stack.empty()) {
+			const node_t x = stack.back(); stack.pop_back();
+			for (const auto &e : this->edges(x))
+				if (base::target(e) != dst[x]) dst[base::target(e)] = x, stack.push_back(base::target(e));
+		}
+	}
 	std::vector<node_t> parents(node_t root) const {
 		std::vector<node_t> ret; ret.resize(this->size());
 		get_parents(root, ret.data());
 		return ret;
 	}
+	traversal traverse(node_t root) const {
+		const size_t n = this->size();
+		traversal ret;
+		ret.parent.resize(n); ret.depth.resize(n); ret.size.assign(n, 1);
+		ret.order.reserve(n);
+		std::vector<node_t> stack{ root };
+		ret.parent[root] = -1; ret.depth[root] = 0;
+		while (!stack.empty()) {
+			const node_t x = stack.back(); stack.pop_back();
+			ret.order.push_back(x);
+			const auto &e = this->edges(x);
+			for (size_t i = e.size(); i--; ) {
+				const node_t v = base::target(e[i]);
+				if (v == ret.parent[x]) continue;
+				ret.parent[v] = x; ret.depth[v] = ret.depth[x] + 1;
+				stack.push_back(v);
+			}
+		}
+		for (size_t i = ret.order.size(); --i; ) ret.size[ret.parent[ret.order[i]]] += ret.size[ret.order[i]];
+		return ret;
+	}
 	inline std::vector<node_t> prufer_code() const {
 		const size_t n = this->size();
 		auto pa = parents(n - 1);
@@ -188,6 +541,241 @@ struct tree : public weighted_tree<void> {
 		return ret;
 	}
 };
+// Lowest common ancestors on a tree rooted at `root`, in O(1) per query after an
+// O(n log n) build: a sparse table over the DFS order keeps, for every position, the
+// DFS index of the parent of the node there, and the LCA of u != v is the node whose
+// index is the minimum over (tin[u], tin[v]]. Everything is stored as flat uint32_t
+// arrays. Also answers depths, (weighted) distances and k'th ancestors.
+template<class V = int>
+struct lca_index {
+	using node_t = size_t;
+	using dist_t = std::conditional_t<std::is_void_v<V>, size_t, V>;
+private:
+	using base = base_graph<V, false>;
+	size_t n = 0, levels = 0;
+	std::vector<uint32_t> tin, dep, table, by_depth, depth_start;
+	std::vector<node_t> order;
+	std::vector<dist_t> dist;
+	inline const uint32_t* level(size_t k) const { return table.data() + k * n; }
+public:
+	lca_index() {}
+	lca_index(const weighted_tree<V> &t, node_t root): n(t.size()), tin(n), dep(n), dist(n) {
+		assert(n < (1ULL << 32) && root < n);
+		order.reserve(n);
+		std::vector<node_t> par(n), stack{ root };
+		par[root] = -1; dist[root] = dist_t();
+		while (!stack.empty()) {
+			const node_t x = stack.back(); stack.pop_back();
+			tin[x] = order.size(); order.push_back(x);
+			const auto &e = t.edges(x);
+			for (size_t i = e.size(); i--; ) {
+				const node_t v = base::target(e[i]);
+				if (v == par[x]) continue;
+				par[v] = x; dep[v] = dep[x] + 1;
+				if constexpr (base::has_info) dist[v] = dist[x] + e[i].second;
+				else dist[v] = dep[v];
+				stack.push_back(v);
+			}
+		}
+		levels = 1;
+		while ((size_t)1 << levels <= n) ++levels;
+		table.resize(levels * n);
+		uint32_t *t0 = table.data();
+		t0[0] = 0;
+		for (size_t i = 1; i < n; ++i) t0[i] = tin[par[order[i]]];
+		for (size_t k = 1; k < levels; ++k) {
+			const uint32_t *p = level(k - 1);
+			uint32_t *q = table.data() + k * n;
+			const size_t h = (size_t)1 << (k - 1);
+			for (size_t i = 0; i + (h << 1) <= n; ++i) q[i] = std::min(p[i], p[i + h]);
+		}
+		// nodes of each depth in DFS order, for kth_ancestor
+		depth_start.assign(n + 1, 0);
+		for (size_t i = 0; i < n; ++i) ++depth_start[dep[i] + 1];
+		for (size_t i = 0; i < n; ++i) depth_start[i + 1] += depth_start[i];
+		by_depth.resize(n);
+		std::vector<uint32_t> pos(depth_start.begin(), depth_start.end() - 1);
+		for (node_t x : order) by_depth[pos[dep[x]]++] = tin[x];
+	}
+
+	inline size_t size() const { return n; }
+	inline node_t root() const { return order[0]; }
+	inline size_t depth(node_t u) const { return dep[u]; }
+	// position of u in the DFS order
+	inline size_t index(node_t u) const { return tin[u]; }
+	inline node_t parent(node_t u) const { return kth_ancestor(u, 1); }
+	inline node_t lca(node_t u, node_t v) const {
+		if (u == v) return u;
+		size_t a = tin[u], b = tin[v];
+		if (a > b) std::swap(a, b);
+		++a;
+		const size_t k = 63 - __builtin_clzll(b - a + 1);
+		const uint32_t *t = level(k);
+		return order[std::min(t[a], t[b + 1 - ((size_t)1 << k)])];
+	}
+	inline bool is_ancestor(node_t u, node_t v) const { return lca(u, v) == u; }
+	// sum of edge weights (edge count on unweighted trees) from the root
+	inline dist_t root_distance(node_t u) const { return dist[u]; }
+	inline dist_t distance(node_t u, node_t v) const { return dist[u] + dist[v] - 2 * dist[lca(u, v)]; }
+	// the ancestor k levels above u (u itself for k = 0), -1 past the root
+	inline node_t kth_ancestor(node_t u, size_t k) const {
+		if (k > dep[u]) return -1;
+		const size_t d = dep[u] - k;
+		// the last node at depth d entered before u
+		const uint32_t *b = by_depth.data() + depth_start[d], *e = by_depth.data() + depth_start[d + 1];
+		return order[*(std::upper_bound(b, e, tin[u]) - 1)];
+	}
+};
+// Heavy-light decomposition of a tree rooted at `root`, built without recursion. The
+// per-node fields live together in one array; positions put every heavy chain and
+// every subtree in a contiguous range, so path and subtree queries become O(log n)
+// and one range of position-indexed arrays respectively.
+template<class V = int>
+struct heavy_light {
+	using node_t = size_t;
+	using weight_t = std::conditional_t<std::is_void_v<V>, char, V>;
+	struct entry {
+		uint32_t parent, heavy, head, pos, depth, size;
+	};
+	static constexpr uint32_t none = -1;
+private:
+	using base = base_graph<V, false>;
+	std::vector<entry> a;
+	std::vector<node_t> at;
+	std::vector<weight_t> w;
+public:
+	heavy_light() {}
+	heavy_light(const weighted_tree<V> &t, node_t root): a(t.size()), at(t.size()) {
+		const size_t n = t.size();
+		assert(n < (1ULL << 32) && root < n);
+		const auto tr = t.traverse(root);
+		for (node_t x = 0; x < n; ++x) {
+			a[x].parent = tr.parent[x] == (node_t)-1? none: tr.parent[x];
+			a[x].heavy = none; a[x].depth = tr.depth[x]; a[x].size = tr.size[x];
+		}
+		for (node_t x : tr.order)
+			if (x != root) {
+				entry &p = a[a[x].parent];
+				if (p.heavy == none || a[x].size > a[p.heavy].size) p.heavy = x;
+			}
+		if constexpr (base::has_info) w.resize(n);
+		// heavy child pushed last, so it is popped next and continues the chain
+		std::vector<node_t> stack{ root };
+		a[root].head = root;
+		uint32_t cur = 0;
+		while (!stack.empty()) {
+			const node_t x = stack.back(); stack.pop_back();
+			a[x].pos = cur; at[cur++] = x;
+			for (const auto &e : t.edges(x)) {
+				const node_t v = base::target(e);
+				if (v == a[x].parent) continue;
+				if (v != a[x].heavy) a[v].head = v, stack.push_back(v);
+			}
+			if (a[x].heavy != none) {
+				a[a[x].heavy].head = a[x].head;
+				stack.push_back(a[x].heavy);
+			}
+		}
+		if constexpr (base::has_info)
+			for (node_t x = 0; x < n; ++x)
+				for (const auto &[v, c] : t.edges(x))
+					if (a[v].parent == x) w[a[v].pos] = c;
+	}
+
+	inline size_t size() const { return a.size(); }
+	inline const entry& operator[](node_t x) const { return a[x]; }
+	inline node_t parent(node_t x) const { return a[x].parent == none? (node_t)-1: a[x].parent; }
+	inline node_t heavy(node_t x) const { return a[x].heavy == none? (node_t)-1: a[x].heavy; }
+	inline node_t head(node_t x) const { return a[x].head; }
+	inline size_t pos(node_t x) const { return a[x].pos; }
+	inline size_t depth(node_t x) const { return a[x].depth; }
+	inline size_t subtree_size(node_t x) const { return a[x].size; }
+	// the node at a position
+	inline node_t node_at(size_t p) const { return at[p]; }
+	// weights()[pos(x)]: weight of the edge from x to its parent (has_info only)
+	inline const std::vector<weight_t>& weights() const { return w; }
+
+	inline node_t lca(node_t u, node_t v) const {
+		while (a[u].head != a[v].head) {
+			if (a[a[u].head].depth < a[a[v].head].depth) std::swap(u, v);
+			u = a[a[u].head].parent;
+		}
+		return a[u].depth < a[v].depth? u: v;
+	}
+	// Calls f(l, r) for O(log n) disjoint position ranges [l, r) covering the path
+	// u - v (in no particular order). With `edges`, the lca is left out, so the ranges
+	// cover the positions of the path's edges (see weights()).
+	template<class F>
+	void path(node_t u, node_t v, F &&f, bool edges = false) const {
+		while (a[u].head != a[v].head) {
+			if (a[a[u].head].depth < a[a[v].head].depth) std::swap(u, v);
+			f((size_t)a[a[u].head].pos, (size_t)a[u].pos + 1);
+			u = a[a[u].head].parent;
+		}
+		if (a[u].depth > a[v].depth) std::swap(u, v);
+		if (a[u].pos + edges <= a[v].pos) f((size_t)a[u].pos + edges, (size_t)a[v].pos + 1);
+	}
+	// positions [l, r) of the subtree of x
+	inline std::pair<size_t, size_t> subtree(node_t x) const { return { a[x].pos, a[x].pos + a[x].size }; }
+};
+
+// Centroid decomposition, built without recursion: parent(x) is the centroid whose
+// removal put x in its component (-1 for the first centroid), level(x) the depth of x
+// in the centroid tree (at most log2 n), order the centroids in the order they were
+// picked, so every centroid comes after its parent.
+template<class V = int>
+struct centroid_decomposition {
+	using node_t = size_t;
+	std::vector<node_t> parent, order;
+	std::vector<uint32_t> level;
+	centroid_decomposition() {}
+	explicit centroid_decomposition(const weighted_tree<V> &t): parent(t.size(), -1), level(t.size()) {
+		using base = base_graph<V, false>;
+		const size_t n = t.size();
+		if (!n) return;
+		order.reserve(n);
+		// work on a packed copy relabelled in DFS order, so that components, which are
+		// mostly runs of nearby labels, stay cache-friendly level after level
+		const auto tr = t.traverse(0);
+		std::vector<node_t> id(n), off(n + 1), to((n - 1) << 1);
+		for (size_t i = 0; i < n; ++i) id[tr.order[i]] = i;
+		for (size_t i = 0; i < n; ++i) {
+			off[i + 1] = off[i];
+			for (const auto &e : t.edges(tr.order[i])) to[off[i + 1]++] = id[base::target(e)];
+		}
+		std::vector<char> removed(n);
+		std::vector<node_t> par(n), sz(n), comp;
+		// components still to split: (any node of it, centroid it hangs from)
+		std::vector<std::pair<node_t, node_t>> todo{ { 0, (node_t)-1 } };
+		for (size_t qi = 0; qi < todo.size(); ++qi) {
+			const auto [s, up] = todo[qi];
+			comp.clear(); comp.push_back(s);
+			par[s] = -1;
+			for (size_t i = 0; i < comp.size(); ++i) {
+				const node_t x = comp[i];
+				sz[x] = 1;
+				for (size_t j = off[x]; j < off[x + 1]; ++j)
+					if (to[j] != par[x] && !removed[to[j]]) par[to[j]] = x, comp.push_back(to[j]);
+			}
+			for (size_t i = comp.size(); --i; ) sz[par[comp[i]]] += sz[comp[i]];
+			const size_t total = comp.size();
+			node_t c = s;
+			for (bool moved = true; moved; ) {
+				moved = false;
+				for (size_t j = off[c]; j < off[c + 1]; ++j)
+					if (to[j] != par[c] && !removed[to[j]] && sz[to[j]] * 2 > total) { c = to[j]; moved = true; break; }
+			}
+			removed[c] = 1;
+			const node_t oc = tr.order[c];
+			parent[oc] = up;
+			level[oc] = up == (node_t)-1? 0: level[up] + 1;
+			order.push_back(oc);
+			for (size_t j = off[c]; j < off[c + 1]; ++j)
+				if (!removed[to[j]]) todo.emplace_back(to[j], oc);
+		}
+	}
+	inline node_t root() const { return order.empty()? -1: order[0]; }
+};
 struct binary_tree {
 	using node_t = size_t;
 private:
@@ -233,5 +821,293 @@ public:
 	}
 };
 
+// Single-source shortest paths. Every function takes any graph with size() and
+// edges(x) (base_graph and its subclasses, csr_graph, csr_view) and returns distances
+// (inf where unreachable) and the parent of each node on its shortest path (-1 for
+// the source and unreachable nodes).
+template<class D>
+struct shortest_path_tree {
+	static constexpr D inf = std::numeric_limits<D>::max();
+	std::vector<D> dist;
+	std::vector<size_t> parent;
+	shortest_path_tree(size_t n): dist(n, inf), parent(n, -1) {}
+};
+
+template<class G>
+using weight_of = std::decay_t<decltype(std::declval<typename G::edge_type>().second)>;
+
+// Priority queues for dijkstra. Each one has a (node count, largest edge weight)
+// constructor, push(key, node) and pop() -> (key, node) returning the smallest key;
+// a node may be pushed again with a smaller key, and pop may then hand out stale
+// entries, which dijkstra skips.
+
+// Indexed binary heap with decrease-key: at most one entry per node, no stale pops.
+template<class D>
+struct binary_heap {
+	static constexpr bool bounded = false;
+	std::vector<std::pair<D, size_t>> h;
+	std::vector<size_t> pos;
+	binary_heap(size_t n, D = D()): pos(n, -1) {}
+	inline bool empty() const { return h.empty(); }
+	inline void push(D k, size_t x) {
+		size_t i = pos[x];
+		if (i == (size_t)-1) i = h.size(), h.emplace_back(k, x);
+		else if (k < h[i].first) h[i].first = k;
+		else return;
+		for (; i; ) {
+			const size_t p = (i - 1) >> 1;
+			if (!(k < h[p].first)) break;
+			h[i] = h[p]; pos[h[i].second] = i; i = p;
+		}
+		h[i] = { k, x }; pos[x] = i;
+	}
+	inline std::pair<D, size_t> pop() {
+		const auto ret = h[0];
+		pos[ret.second] = -1;
+		const auto last = h.back(); h.pop_back();
+		if (!h.empty()) {
+			size_t i = 0;
+			for (const size_t n = h.size(); ; ) {
+				size_t c = (i << 1) + 1;
+				if (c >= n) break;
+				if (c + 1 < n && h[c + 1].first < h[c].first) ++c;
+				if (!(h[c].first < last.first)) break;
+				h[i] = h[c]; pos[h[i].second] = i; i = c;
+			}
+			h[i] = last; pos[last.second] = i;
+		}
+		return ret;
+	}
+};
+
+// Radix heap for integer keys: entries sit in the bucket of the highest bit in
+// which they differ from the last popped key, so each one moves O(log C) times.
+// Keys must never drop below the last popped one, which dijkstra guarantees.
+template<class D>
+struct radix_heap {
+	static_assert(std::is_integral_v<D>, "radix_heap needs integer weights");
+	static constexpr bool bounded = false;
+	using key_t = std::make_unsigned_t<D>;
+	static constexpr int BITS = sizeof(key_t) * 8;
+	std::vector<std::pair<key_t, size_t>> b[BITS + 1];
+	key_t last = 0;
+	size_t cnt = 0;
+	radix_heap(size_t = 0, D = D()) {}
+	static inline int bucket(key_t x) { return x? 64 - __builtin_clzll((unsigned long long)x): 0; }
+	inline bool empty() const { return !cnt; }
+	inline void push(D k, size_t x) { b[bucket((key_t)k ^ last)].emplace_back(k, x); ++cnt; }
+	inline std::pair<D, size_t> pop() {
+		if (b[0].empty()) {
+			int i = 1;
+			while (b[i].empty()) ++i;
+			last = b[i][0].first;
+			for (const auto &e : b[i]) last = std::min(last, e.first);
+			for (const auto &e : b[i]) b[bucket(e.first ^ last)].push_back(e);
+			b[i].clear();
+		}
+		const auto ret = b[0].back(); b[0].pop_back(); --cnt;
+		return { (D)ret.first, ret.second };
+	}
+};
+
+// Dial's bucket queue for small integer weights: C + 1 buckets used as a ring,
+// keyed by distance modulo C + 1; O(1) per operation plus O(C) per distance gap.
+template<class D>
+struct dial_queue {
+	static_assert(std::is_integral_v<D>, "dial_queue needs integer weights");
+	static constexpr bool bounded = true;
+	std::vector<std::vector<size_t>> b;
+	D cur = 0;
+	size_t cnt = 0;
+	dial_queue(size_t, D max_weight): b((size_t)max_weight + 1) {}
+	inline bool empty() const { return !cnt; }
+	inline void push(D k, size_t x) { b[(size_t)k % b.size()].push_back(x); ++cnt; }
+	inline std::pair<D, size_t> pop() {
+		while (b[(size_t)cur % b.size()].empty()) ++cur;
+		auto &q = b[(size_t)cur % b.size()];
+		const size_t x = q.back(); q.pop_back(); --cnt;
+		return { cur, x };
+	}
+};
+
+// Dijkstra with non-negative weights, on the queue of your choice:
+//   dijkstra(g, s)                  binary_heap
+//   dijkstra<radix_heap>(g, s)      integer weights
+//   dijkstra<dial_queue>(g, s)      small integer weights (buckets up to the largest)
+template<template<class> class Queue = binary_heap, class G>
+shortest_path_tree<weight_of<G>> dijkstra(const G &g, size_t source) {
+	using D = weight_of<G>;
+	const size_t n = g.size();
+	shortest_path_tree<D> ret(n);
+	D max_weight = D();
+	if constexpr (Queue<D>::bounded)
+		for (size_t x = 0; x < n; ++x)
+			for (const auto &e : g.edges(x)) max_weight = std::max(max_weight, D(e.second));
+	Queue<D> q(n, max_weight);
+	ret.dist[source] = D();
+	q.push(D(), source);
+	while (!q.empty()) {
+		const auto [d, x] = q.pop();
+		if (ret.dist[x] < d) continue;
+		for (const auto &e : g.edges(x)) {
+			const size_t v = G::target(e);
+			const D nd = d + e.second;
+			if (nd < ret.dist[v]) ret.dist[v] = nd, ret.parent[v] = x, q.push(nd, v);
+		}
+	}
+	return ret;
+}
+
+// Shortest paths when every weight is 0 or 1, with a deque
+template<class G>
+shortest_path_tree<size_t> bfs01(const G &g, size_t source) {
+	const size_t n = g.size();
+	shortest_path_tree<size_t> ret(n);
+	std::deque<size_t> q{ source };
+	ret.dist[source] = 0;
+	while (!q.empty()) {
+		const size_t x = q.front(); q.pop_front();
+		for (const auto &e : g.edges(x)) {
+			const size_t v = G::target(e), w = e.second;
+			assert(w <= 1);
+			if (ret.dist[x] + w < ret.dist[v]) {
+				ret.dist[v] = ret.dist[x] + w; ret.parent[v] = x;
+				if (w) q.push_back(v);
+				else q.push_front(v);
+			}
+		}
+	}
+	return ret;
+}
+
+// Distances in edges, ignoring any edge info
+template<class G>
+shortest_path_tree<size_t> bfs(const G &g, size_t source) {
+	const size_t n = g.size();
+	shortest_path_tree<size_t> ret(n);
+	std::vector<size_t> q{ source };
+	q.reserve(n);
+	ret.dist[source] = 0;
+	for (size_t i = 0; i < q.size(); ++i) {
+		const size_t x = q[i];
+		for (const auto &e : g.edges(x)) {
+			const size_t v = G::target(e);
+			if (ret.dist[v] == ret.inf) ret.dist[v] = ret.dist[x] + 1, ret.parent[v] = x, q.push_back(v);
+		}
+	}
+	return ret;
+}
+
+namespace detail {
+
+// Direction-optimising BFS (Beamer et al.): top-down steps expand a frontier list,
+// claiming nodes with a CAS on dist; bottom-up steps let every unvisited node look for
+// a parent in the frontier bitmap through its incoming edges (the graph `rev`, null
+// for top-down only). Both are split over threads, top-down in blocks of frontier
+// grabbed from a shared counter, bottom-up in 64-node words of the bitmap.
+template<class G, class Rev>
+shortest_path_tree<size_t> parallel_bfs(const G &g, const Rev *rev, size_t source, unsigned threads) {
+	constexpr size_t ALPHA = 14, BETA = 24, BLOCK = 256;
+	const size_t n = g.size(), words = (n + 63) >> 6;
+	const size_t inf = shortest_path_tree<size_t>::inf;
+	shortest_path_tree<size_t> ret(n);
+	auto &dist = ret.dist;
+	auto &parent = ret.parent;
+	if (!threads) threads = 1;
+	const auto run = [threads](auto &&func) {
+		if (threads == 1) return func(0);
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads; ++i) pool.emplace_back(func, i);
+		func(0);
+		for (auto &t : pool) t.join();
+	};
+	size_t unexplored = 0;
+	for (size_t x = 0; x < n; ++x) unexplored += g.edges(x).size();
+	std::vector<size_t> frontier{ source }, next;
+	std::vector<std::vector<size_t>> local(threads);
+	std::vector<uint64_t> bits, next_bits;
+	std::vector<size_t> found(threads), found_edges(threads);
+	dist[source] = 0;
+	size_t count = 1, edges = g.edges(source).size();
+	bool bottom_up = false;
+	for (size_t level = 0; count; ++level) {
+		unexplored -= edges;
+		if (!bottom_up && rev && edges > unexplored / ALPHA) {
+			bottom_up = true;
+			bits.assign(words, 0);
+			for (size_t x : frontier) bits[x >> 6] |= 1ULL << (x & 63);
+		} else if (bottom_up && count < n / BETA) {
+			bottom_up = false;
+			frontier.clear();
+			for (size_t w = 0; w < words; ++w)
+				for (uint64_t b = bits[w]; b; b &= b - 1) frontier.push_back(w << 6 | __builtin_ctzll(b));
+		}
+		std::fill(found.begin(), found.end(), 0);
+		std::fill(found_edges.begin(), found_edges.end(), 0);
+		if (bottom_up) {
+			next_bits.assign(words, 0);
+			run([&](unsigned t) {
+				for (size_t w = words * t / threads, we = words * (t + 1) / threads; w < we; ++w)
+					for (size_t v = w << 6, ve = std::min(n, v + 64); v < ve; ++v) {
+						if (dist[v] != inf) continue;
+						for (const auto &e : rev->edges(v)) {
+							const size_t u = Rev::target(e);
+							if (bits[u >> 6] >> (u & 63) & 1) {
+								dist[v] = level + 1; parent[v] = u;
+								next_bits[w] |= 1ULL << (v & 63);
+								++found[t]; found_edges[t] += g.edges(v).size();
+								break;
+							}
+						}
+					}
+			});
+			std::swap(bits, next_bits);
+		} else {
+			size_t shared = 0;
+			run([&](unsigned t) {
+				auto &out = local[t];
+				out.clear();
+				for (size_t b; (b = __atomic_fetch_add(&shared, BLOCK, __ATOMIC_RELAXED)) < frontier.size(); )
+					for (size_t i = b, ie = std::min(frontier.size(), b + BLOCK); i < ie; ++i) {
+						const size_t x = frontier[i];
+						for (const auto &e : g.edges(x)) {
+							const size_t v = G::target(e);
+							size_t expected = inf;
+							if (__atomic_load_n(&dist[v], __ATOMIC_RELAXED) == inf
+								&& __atomic_compare_exchange_n(&dist[v], &expected, level + 1, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+								parent[v] = x;
+								out.push_back(v);
+								found_edges[t] += g.edges(v).size();
+							}
+						}
+					}
+				found[t] = out.size();
+			});
+			next.clear();
+			for (auto &out : local) next.insert(next.end(), out.begin(), out.end());
+			std::swap(frontier, next);
+		}
+		count = edges = 0;
+		for (unsigned t = 0; t < threads; ++t) count += found[t], edges += found_edges[t];
+	}
+	return ret;
+}
+
+} // namespace detail
+
+// BFS distances and parents (as in bfs) using `threads` threads, switching between
+// top-down and bottom-up steps by frontier size. Bottom-up steps need the incoming
+// edges of every node: undirected graphs are their own transpose, directed ones run
+// top-down only unless the transpose is passed as well.
+template<class G>
+shortest_path_tree<size_t> parallel_bfs(const G &g, size_t source, unsigned threads = std::thread::hardware_concurrency()) {
+	return detail::parallel_bfs(g, G::is_directed? nullptr: &g, source, threads);
+}
+template<class G, class Rev, std::enable_if_t<std::is_class_v<Rev>, int> = 0>
+shortest_path_tree<size_t> parallel_bfs(const G &g, const Rev &transpose, size_t source, unsigned threads = std::thread::hardware_concurrency()) {
+	assert(transpose.size() == g.size());
+	return detail::parallel_bfs(g, &transpose, source, threads);
+}
+
 } // namespace graph
 } // namespace mic
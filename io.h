@@ -1,29 +1,77 @@
 
 #pragma once
 
+#include <charconv>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifdef __SSE4_1__
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 // coco: preserve_begin
-#define d isdigit(c)
+#define d ((unsigned char)(c-48)<10)
 #define g c=t.get();
 #define L return
 #define K break
 #define A(c,a,b)if(c)a else b;
 #define I(c,a)if(c)a;
 #define Y goto E
-struct MI{private:char bb[1 << 14];FILE*f;char*bs,*be;char e;bool o,l;public:MI():f(stdin),bs(0),be(0){}MI(FILE*f):f(f),bs(0),be(0){}
+struct MI{private:char bb[1 << 14];FILE*f;char*bs,*be,*mb;char e;bool o,l,m;public:MI(FILE*f=stdin,bool m=0):f(f),bs(0),be(0),mb(0),o(0),l(0),m(0){
+#if defined(__linux__)&&!defined(MIVIK)
+// map the rest of a regular file and parse it in place, pipes and ttys stay buffered
+struct stat s;long p;I(!m||fstat(fileno(f),&s)||!S_ISREG(s.st_mode)||(p=ftell(f))<0||p>=s.st_size,L)void*a=mmap(0,s.st_size,PROT_READ,MAP_PRIVATE|MAP_POPULATE,fileno(f),0);I(a==MAP_FAILED,L)madvise(a,s.st_size,MADV_SEQUENTIAL);mb=(char*)a;bs=mb+p;be=mb+s.st_size;this->m=1;
+#else
+(void)m;
+#endif
+}MI(const MI&)=delete;
+#ifdef MIVIK
+#ifdef __linux__
+MI(const char*b,const char*e):MI(fmemopen(const_cast<char*>(b),e-b,"r")){}
+#endif
+#else
+// parse [b, e) in place
+MI(const char*b,const char*e):f(0),bs(const_cast<char*>(b)),be(const_cast<char*>(e)),mb(0),o(0),l(0),m(1){}
+#endif
 #ifdef __linux__
-MI(const char*s):f(fmemopen(const_cast<char*>(s),strlen(s),"r")){}
+MI(const char*s):MI(fmemopen(const_cast<char*>(s),strlen(s),"r")){}~MI(){I(mb,munmap(mb,be-mb))}
 #endif
 inline operator bool(){L!l;}inline char get(){if(o){o=0;L e;}
 #ifdef MIVIK
 char c=fgetc(f);I(c==-1,l=1)L c;
 #else
-I(bs==be,be=(bs=bb)+fread(bb,1,sizeof(bb),f))I(bs==be,{l=1;L-1;})L*bs++;
+I(bs==be,{I(!m,be=(bs=bb)+fread(bb,1,sizeof(bb),f))I(bs==be,{l=1;L-1;})})L*bs++;
 #endif
-}inline void unget(char c){o=1;e=c;}template<class T>inline T read(){T r;*this>r;L r;}template<class T>inline MI&operator>(T&);};template<class T>struct Q{const static bool U=T(-1)>=T(0);inline void operator()(MI&t,T&r)const{r=0;char c;bool y=0;A(U,for(;;){g I(c==-1,Y)I(d,K)},for(;;){g I(c==-1,Y)A(c=='-',{g I(d,{y=1;K;})},I(d,K))})for(;;){I(c==-1,Y)A(d,r=r*10+(c^48);,K)g}t.unget(c);E:;I(y,r=-r)}};template<>struct Q<char>{inline void operator()(MI&t,char&r){int c;for(;;){g I(c==-1,{r=-1;L;})I(!isspace(c),{r=c;L;})}}};template<class T>inline MI&MI::operator>(T&t){Q<T>()(*this,t);L*this;}
+}inline void unget(char c){o=1;e=c;}
+// the next whitespace-separated token / the rest of the current line, pointing into the buffer when possible
+// (valid until the next read, forever in mmap mode) and into a spill string otherwise
+inline std::string_view token(){L sv(0);}inline std::string_view line(){std::string_view r=sv(1);I(!r.empty()&&r.back()=='\r',r.remove_suffix(1))L r;}template<class T>inline void rf(T&r){std::string_view s=token();r=0;I(!s.empty()&&s[0]=='+',s.remove_prefix(1))std::from_chars(s.data(),s.data()+s.size(),r);}private:std::string sp;static inline bool ws(char c){L c==32||(unsigned char)(c-9)<5;}inline std::string_view sv(bool k){int c;bool u;for(;;){u=o;c=get();I(c==-1,L{})I(k||!ws(c),K)}I(k&&c=='\n',L{})
+#ifdef MIVIK
+sp.assign(1,c);(void)u;
+#else
+A(u,sp.assign(1,c);,{char*p=bs-1;char*q=bs;for(;q<be;++q)I(k?*q=='\n':ws(*q),{bs=q+k;L std::string_view(p,q-p);})bs=q;I(m,L std::string_view(p,q-p))sp.assign(p,q);})
+#endif
+for(;;){c=get();I(c==-1,K)I(k?c=='\n':ws(c),{I(!k,unget(c))K;})sp+=c;}L sp;}public:template<class T>inline void sd(T&r){sd(bs,be,r);}template<class T>static inline void sd(char*&bs,const char*be,T&r){
+#ifdef __SSE4_1__
+// consume the digit run at bs 16 bytes at a time: mask the digits, right-align them and fold 1->2->4->8 digits with multiply-adds
+static constexpr unsigned long long w[17]={1,10,100,1000,10000,100000,1000000,10000000,100000000,1000000000,10000000000,100000000000,1000000000000,10000000000000,100000000000000,1000000000000000,10000000000000000};for(;be-bs>=16;){__m128i x=_mm_sub_epi8(_mm_loadu_si128((const __m128i*)bs),_mm_set1_epi8(48));int k=__builtin_ctz(~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(x,_mm_set1_epi8(9)),x)));I(!k,K)x=_mm_shuffle_epi8(x,_mm_add_epi8(_mm_setr_epi8(0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15),_mm_set1_epi8(k-16)));x=_mm_maddubs_epi16(x,_mm_setr_epi8(10,1,10,1,10,1,10,1,10,1,10,1,10,1,10,1));x=_mm_madd_epi16(x,_mm_setr_epi16(100,1,100,1,100,1,100,1));x=_mm_packus_epi32(x,x);x=_mm_madd_epi16(x,_mm_setr_epi16(10000,1,10000,1,10000,1,10000,1));r=r*(T)w[k]+(T)((unsigned long long)(unsigned)_mm_cvtsi128_si32(x)*100000000+(unsigned)_mm_extract_epi32(x,1));bs+=k;I(k<16,K)}
+#else
+(void)bs;(void)be;(void)r;
+#endif
+}template<class T>inline T read(){T r;*this>r;L r;}template<class T>inline MI&operator>(T&);template<class T>inline void read_n(T*,size_t);template<class T>inline void read_n(std::vector<T>&v,size_t n){v.resize(n);read_n(v.data(),n);}};template<class T>struct Q{const static bool U=T(-1)>=T(0);inline void operator()(MI&t,T&r)const{r=0;char c;bool y=0;A(U,for(;;){g I(c==-1,Y)I(d,K)},for(;;){g I(c==-1,Y)A(c=='-',{g I(d,{y=1;K;})},I(d,K))})for(;;){I(c==-1,Y)A(d,{r=r*10+(c^48);t.sd(r);},K)g}t.unget(c);E:;I(y,r=-r)}};template<>struct Q<char>{inline void operator()(MI&t,char&r){int c;for(;;){g I(c==-1,{r=-1;L;})I(!isspace(c),{r=c;L;})}}};template<>struct Q<std::string_view>{inline void operator()(MI&t,std::string_view&r){r=t.token();}};template<>struct Q<std::string>{inline void operator()(MI&t,std::string&r){r=t.token();}};template<>struct Q<float>{inline void operator()(MI&t,float&r){t.rf(r);}};template<>struct Q<double>{inline void operator()(MI&t,double&r){t.rf(r);}};template<>struct Q<long double>{inline void operator()(MI&t,long double&r){t.rf(r);}};template<class T>inline MI&MI::operator>(T&t){Q<T>()(*this,t);L*this;}
+// integers are parsed straight from the buffer and only a token touching its end goes through Q
+template<class T>inline void MI::read_n(T*a,size_t n){if constexpr(std::is_integral_v<T>&&!std::is_same_v<T,char>){for(;n;--n,++a){char*p=bs,c;T r;bool y=0;I(o||be-p<64,goto F)for(;;){I(p==be,goto F)c=*p++;I(d,K)I(!Q<T>::U&&c=='-',{I(p==be,goto F)c=*p++;I(d,{y=1;K;})})}r=c^48;for(;;){sd(p,be,r);I(p==be,goto F)c=*p;I(!d,K)r=r*10+(c^48);++p;}bs=p;*a=y?-r:r;continue;F:*this>*a;}}else for(;n;--n)*this>*a++;}
+struct MO{private:char bb[1 << 16],*bs;FILE*f;static constexpr char D[201]="00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";public:MO(FILE*f=stdout):bs(bb),f(f){}MO(const MO&)=delete;~MO(){flush();}inline void flush(){fwrite(bb,1,bs-bb,f);bs=bb;fflush(f);}inline void put(char c){I(bs==bb+sizeof(bb),flush())*bs++=c;}inline void write(const char*s,size_t n){I(n>=sizeof(bb),{flush();fwrite(s,1,n,f);L;})for(size_t k;n;s+=k,n-=k){I(bs==bb+sizeof(bb),flush())k=bb+sizeof(bb)-bs;I(k>n,k=n)memcpy(bs,s,k);bs+=k;}}template<class T>inline void wi(T t){I(bb+sizeof(bb)-bs<48,flush())std::make_unsigned_t<T>u=t;if constexpr(std::is_signed_v<T>)I(t<0,{*bs++='-';u=-u;})char s[40],*p=s+40;for(;u>=100;u/=100)memcpy(p-=2,D+u%100*2,2);A(u>=10,memcpy(p-=2,D+u*2,2);,*--p=48|u;)memcpy(bs,p,s+40-p);bs+=s+40-p;}template<class T>inline MO&operator<(const T&t){if constexpr(std::is_same_v<T,char>||std::is_same_v<T,signed char>||std::is_same_v<T,unsigned char>)put(t);else if constexpr(std::is_same_v<T,bool>)put(48|t);else if constexpr(std::is_integral_v<T>)wi(t);else if constexpr(std::is_floating_point_v<T>){char s[64];write(s,snprintf(s,64,"%g",(double)t));}else{std::string_view s(t);write(s.data(),s.size());}L*this;}};
 #undef d
 #undef g
 #undef L
@@ -37,4 +85,7 @@ template<class T>std::ostream& operator<(std::ostream&out,const T&t){return out<
 #define R (cin.read<int>())
 // coco: preserve_end
 
+// define MO_COUT before including to declare "MO cout;" yourself
+#ifndef MO_COUT
 using std::cout;
+#endif
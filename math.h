@@ -16,3 +16,27 @@ inline qe ksm(qe x, int p = mod - 2) {
 	for (; p; p >>= 1, (x *= x) %= mod) if (p & 1) (ret *= x) %= mod;
 	return ret;
 }
+
+// Barrett reduction for a modulus chosen at runtime (1 <= m < 2^31), with the same
+// helpers as above. reduce(z) needs z < m^2.
+struct barrett {
+	unsigned m;
+	unsigned long long im;
+	explicit barrett(unsigned m = 1): m(m), im(-1ULL / m + 1) {}
+	inline unsigned reduce(unsigned long long z) const {
+		const unsigned long long x = (unsigned long long)(((unsigned __int128)z * im) >> 64);
+		const unsigned v = z - x * m;
+		return m <= v? v + m: v;
+	}
+	inline int mul(int x, int y) const { return reduce((unsigned long long)x * y); }
+	inline int add(int x, int y) const { const unsigned s = (unsigned)x + y; return s >= m? s - m: s; }
+	inline void Add(int &x, int y) const { x = add(x, y); }
+	inline int sub(int x, int y) const { return (x -= y) < 0? x + m: x; }
+	inline void Sub(int &x, int y) const { if ((x -= y) < 0) x += m; }
+	inline qe ksm(qe x, qe p) const {
+		unsigned ret = 1 % m, b = x;
+		for (; p; p >>= 1, b = reduce((unsigned long long)b * b)) if (p & 1) ret = reduce((unsigned long long)ret * b);
+		return ret;
+	}
+	inline qe ksm(qe x) const { return ksm(x, m - 2); }
+};
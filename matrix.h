@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mint.h"
+
+// coco: preserve_begin
+// A dense n x m matrix over any of the mint types, stored row-major in one vector.
+// For the 32-bit types a product accumulates raw 64-bit products a row at a time and
+// only folds them every few terms (see lazy_traits in mint.h); pow reuses its buffers.
+template<class T = mint>
+struct matrix {
+	typedef lazy_traits<T> tr;
+	typedef typename tr::W W;
+
+	size_t n, m;
+	std::vector<T> a;
+	matrix(size_t n = 0, size_t m = 0, T x = T(0)): n(n), m(m), a(n * m, x) {}
+	static matrix identity(size_t n) {
+		matrix ret(n, n);
+		for (size_t i = 0; i < n; ++i) ret[i][i] = T(1);
+		return ret;
+	}
+	inline T* operator[](size_t i) { return a.data() + i * m; }
+	inline const T* operator[](size_t i) const { return a.data() + i * m; }
+
+	// z = x * y; z must not be x or y, acc is scratch
+	static void mul_to(const matrix &x, const matrix &y, matrix &z, std::vector<W> &acc) {
+		assert(x.m == y.n && &z != &x && &z != &y);
+		z.n = x.n; z.m = y.m;
+		z.a.resize(z.n * z.m);
+		acc.resize(y.m);
+		if constexpr (std::is_same<W, unsigned long long>::value) {
+			// acc stays below 2^63 + mod between folds, so kb products of at most
+			// (mod - 1)^2 each fit before the next one
+			const W md = tr::get_mod(), fold = (1ULL << 63) / md * md, sq = (md - 1) * (md - 1);
+			const size_t kb = sq? std::max<W>(1, ((1ULL << 63) - md) / sq): x.m;
+			for (size_t i = 0; i < x.n; ++i) {
+				std::fill(acc.begin(), acc.end(), 0);
+				const T *xr = x[i];
+				for (size_t k0 = 0; k0 < x.m; k0 += kb) {
+					const size_t k1 = std::min(k0 + kb, x.m);
+					for (size_t k = k0; k < k1; ++k) {
+						const T xv = xr[k], *yr = y[k];
+						for (size_t j = 0; j < y.m; ++j) acc[j] += tr::prod(xv, yr[j]);
+					}
+					if (k1 < x.m) for (size_t j = 0; j < y.m; ++j) acc[j] -= acc[j] >= fold? fold: 0;
+				}
+				T *zr = z[i];
+				for (size_t j = 0; j < y.m; ++j) zr[j] = tr::finish(acc[j]);
+			}
+		} else {
+			for (size_t i = 0; i < x.n; ++i) {
+				T *zr = z[i];
+				std::fill(zr, zr + z.m, T(0));
+				for (size_t k = 0; k < x.m; ++k) {
+					const T xv = x[i][k], *yr = y[k];
+					for (size_t j = 0; j < y.m; ++j) zr[j] += xv * yr[j];
+				}
+			}
+		}
+	}
+
+	inline matrix operator*(const matrix &t) const {
+		matrix ret;
+		std::vector<W> acc;
+		mul_to(*this, t, ret, acc);
+		return ret;
+	}
+	inline std::vector<T> operator*(const std::vector<T> &v) const {
+		assert(v.size() == m);
+		std::vector<T> ret(n);
+		for (size_t i = 0; i < n; ++i) ret[i] = dot((*this)[i], v.data(), m);
+		return ret;
+	}
+	inline matrix operator+(const matrix &t) const {
+		assert(n == t.n && m == t.m);
+		matrix ret = *this;
+		for (size_t i = 0; i < a.size(); ++i) ret.a[i] += t.a[i];
+		return ret;
+	}
+	inline matrix operator-(const matrix &t) const {
+		assert(n == t.n && m == t.m);
+		matrix ret = *this;
+		for (size_t i = 0; i < a.size(); ++i) ret.a[i] -= t.a[i];
+		return ret;
+	}
+	inline void operator*=(const matrix &t) { *this = *this * t; }
+	inline bool operator==(const matrix &t) const { return n == t.n && m == t.m && a == t.a; }
+	inline bool operator!=(const matrix &t) const { return !(*this == t); }
+
+	// square matrices only
+	matrix pow(qe p) const {
+		assert(n == m && p >= 0);
+		matrix ret = identity(n), x = *this, t;
+		std::vector<W> acc;
+		for (; p; p >>= 1) {
+			if (p & 1) { mul_to(ret, x, t, acc); std::swap(ret, t); }
+			if (p > 1) { mul_to(x, x, t, acc); std::swap(x, t); }
+		}
+		return ret;
+	}
+};
+
+// The shortest recurrence s[i] = c[0] s[i - 1] + ... + c[d - 1] s[i - d] that
+// generates s (needs a field, i.e. a prime modulus); 2d terms are enough to find it.
+template<class T>
+std::vector<T> berlekamp_massey(const std::vector<T> &s) {
+	std::vector<T> c(1, T(1)), b(1, T(1)), tmp;
+	size_t l = 0, k = 1;
+	T last = T(1);
+	for (size_t i = 0; i < s.size(); ++i) {
+		lazy_sum<T> sum;
+		for (size_t j = 0; j <= l; ++j) sum.add(c[j], s[i - j]);
+		const T d = sum.get();
+		if (d == T(0)) { ++k; continue; }
+		const T coef = d / last;
+		tmp = c;
+		if (c.size() < b.size() + k) c.resize(b.size() + k, T(0));
+		for (size_t j = 0; j < b.size(); ++j) c[j + k] -= coef * b[j];
+		if (2 * l <= i) { l = i + 1 - l; std::swap(b, tmp); last = d; k = 1; }
+		else ++k;
+	}
+	std::vector<T> ret(l);
+	for (size_t j = 0; j < l; ++j) ret[j] = T(0) - c[j + 1];
+	return ret;
+}
+
+// The k'th term (0-indexed) of s[i] = c[0] s[i - 1] + ... + c[d - 1] s[i - d] given
+// s[0..d), by computing x^k modulo the characteristic polynomial (Kitamasa):
+// O(d^2 log k) instead of the O(d^3 log k) of a d x d matrix power.
+template<class T>
+T linear_recurrence(const std::vector<T> &s, const std::vector<T> &c, qe k) {
+	const size_t d = c.size();
+	assert(s.size() >= d && k >= 0);
+	if ((size_t)k < s.size()) return s[k];
+	if (!d) return T(0);
+	std::vector<T> r(d, T(0)), prod(2 * d);
+	// r = r * r mod the characteristic polynomial
+	auto square = [&] {
+		for (size_t i = 0; i < 2 * d - 1; ++i) {
+			lazy_sum<T> sum;
+			for (size_t j = i < d? 0: i - d + 1; j <= std::min(i, d - 1); ++j) sum.add(r[j], r[i - j]);
+			prod[i] = sum.get();
+		}
+		for (size_t i = 2 * d - 2; i >= d; --i)
+			for (size_t j = 0; j < d; ++j) prod[i - 1 - j] += prod[i] * c[j];
+		std::copy(prod.begin(), prod.begin() + d, r.begin());
+	};
+	// r = r * x mod the characteristic polynomial
+	auto shift = [&] {
+		const T top = r[d - 1];
+		for (size_t i = d - 1; i; --i) r[i] = r[i - 1] + top * c[d - 1 - i];
+		r[0] = top * c[d - 1];
+	};
+	int b = 63;
+	while (!(k >> b & 1)) --b;
+	r[0] = T(1);
+	for (; b >= 0; --b) {
+		square();
+		if (k >> b & 1) shift();
+	}
+	return dot(r.data(), s.data(), d);
+}
+
+// The k'th term of the sequence starting with s, found by berlekamp_massey
+template<class T>
+inline T guess_nth(const std::vector<T> &s, qe k) {
+	return linear_recurrence(s, berlekamp_massey(s), k);
+}
+// coco: preserve_end
@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
 #include "io.h"
 #include "math.h"
 
@@ -22,6 +26,305 @@ struct mint {
 	inline bool operator==(const mint &t) const { return v == t.v; }
 	inline bool operator!=(const mint &t) const { return v != t.v; }
 	friend inline std::ostream& operator<(std::ostream &out, const mint &t) { return out < t.v; }
+	friend inline MO& operator<(MO &out, const mint &t) { return out < t.v; }
 };
 template<> struct Q<mint> { inline void operator()(MI &r, mint &t) { r > t.v; } };
+
+// Montgomery-form residue modulo the odd constant Mod (< 2^30): v holds x * 2^32 % Mod,
+// so a product is two 32x32->64 multiplies and no division. val() gives x back.
+template<int Mod>
+struct static_mint {
+	static_assert((Mod & 1) && 1 < Mod && Mod < (1 << 30), "Mod must be odd and less than 2^30");
+	typedef unsigned u32;
+	typedef unsigned long long u64;
+	static constexpr u32 NINV = [] { u32 r = Mod; for (int i = 0; i < 4; ++i) r *= 2 - Mod * r; return -r; }();
+	static constexpr u32 R2 = -(u64)Mod % Mod;
+	static inline u32 reduce(u64 x) {
+		const u32 t = (x + (u64)((u32)x * NINV) * Mod) >> 32;
+		return t >= (u32)Mod? t - Mod: t;
+	}
+	static inline static_mint raw(u32 v) { static_mint ret; ret.v = v; return ret; }
+	static constexpr int get_mod() { return Mod; }
+
+	u32 v;
+	static_mint() {}
+	static_mint(int x): v(reduce((u64)(x < 0? x % Mod + Mod: x) * R2)) {}
+	explicit static_mint(qe x): v(reduce((u64)((x %= Mod) < 0? x + Mod: x) * R2)) {}
+	inline int val() const { return reduce(v); }
+	inline static_mint pow(qe p) const {
+		static_mint ret = raw(reduce(R2)), x = *this;
+		for (; p; p >>= 1, x *= x) if (p & 1) ret *= x;
+		return ret;
+	}
+	inline static_mint inv() const { return pow(Mod - 2); }
+	inline static_mint operator+(const static_mint &t) const { return raw(v + t.v >= (u32)Mod? v + t.v - Mod: v + t.v); }
+	inline static_mint operator-(const static_mint &t) const { return raw(v < t.v? v - t.v + Mod: v - t.v); }
+	inline static_mint operator*(const static_mint &t) const { return raw(reduce((u64)v * t.v)); }
+	inline static_mint operator/(const static_mint &t) const { return *this * t.inv(); }
+	inline static_mint operator-() const { return raw(v? Mod - v: 0); }
+	inline void operator+=(const static_mint &t) { *this = *this + t; }
+	inline void operator-=(const static_mint &t) { *this = *this - t; }
+	inline void operator*=(const static_mint &t) { v = reduce((u64)v * t.v); }
+	inline void operator/=(const static_mint &t) { *this *= t.inv(); }
+	inline bool operator==(const static_mint &t) const { return v == t.v; }
+	inline bool operator!=(const static_mint &t) const { return v != t.v; }
+	friend inline std::ostream& operator<(std::ostream &out, const static_mint &t) { return out < t.val(); }
+	friend inline MO& operator<(MO &out, const static_mint &t) { return out < t.val(); }
+};
+template<int Mod> struct Q<static_mint<Mod>> { inline void operator()(MI &r, static_mint<Mod> &t) { t = static_mint<Mod>(r.read<qe>()); } };
+
+// Barrett-reduced residue for a modulus below 2^31 picked at runtime. The modulus
+// belongs to the Tag, so several can live side by side:
+//   struct hash1; dynamic_mint<hash1>::set_mod(p);
+template<class Tag = void>
+struct dynamic_mint {
+	static inline barrett bt;
+	static inline void set_mod(int m) { bt = barrett(m); }
+	static inline int get_mod() { return bt.m; }
+	static inline dynamic_mint raw(int v) { dynamic_mint ret; ret.v = v; return ret; }
+
+	int v;
+	dynamic_mint() {}
+	dynamic_mint(int x): v((x %= (int)bt.m) < 0? x + bt.m: x) {}
+	explicit dynamic_mint(qe x): v((x %= bt.m) < 0? x + bt.m: x) {}
+	inline dynamic_mint pow(qe p) const { return raw(bt.ksm(v, p)); }
+	inline dynamic_mint inv() const { return raw(bt.ksm(v)); }
+	inline dynamic_mint operator+(const dynamic_mint &t) const { return raw(bt.add(v, t.v)); }
+	inline dynamic_mint operator-(const dynamic_mint &t) const { return raw(bt.sub(v, t.v)); }
+	inline dynamic_mint operator*(const dynamic_mint &t) const { return raw(bt.mul(v, t.v)); }
+	inline dynamic_mint operator/(const dynamic_mint &t) const { return raw(bt.mul(v, t.inv().v)); }
+	inline dynamic_mint operator-() const { return raw(v? bt.m - v: 0); }
+	inline void operator+=(const dynamic_mint &t) { bt.Add(v, t.v); }
+	inline void operator-=(const dynamic_mint &t) { bt.Sub(v, t.v); }
+	inline void operator*=(const dynamic_mint &t) { v = bt.mul(v, t.v); }
+	inline void operator/=(const dynamic_mint &t) { v = bt.mul(v, t.inv().v); }
+	inline bool operator==(const dynamic_mint &t) const { return v == t.v; }
+	inline bool operator!=(const dynamic_mint &t) const { return v != t.v; }
+	friend inline std::ostream& operator<(std::ostream &out, const dynamic_mint &t) { return out < t.v; }
+	friend inline MO& operator<(MO &out, const dynamic_mint &t) { return out < t.v; }
+};
+template<class Tag> struct Q<dynamic_mint<Tag>> { inline void operator()(MI &r, dynamic_mint<Tag> &t) { t = dynamic_mint<Tag>(r.read<qe>()); } };
+
+// dynamic_mint for odd moduli below 2^62: products go through unsigned __int128 and
+// are Montgomery-reduced, so v is in Montgomery form and val() converts it back.
+template<class Tag = void>
+struct mint64 {
+	typedef unsigned long long u64;
+	typedef unsigned __int128 u128;
+	static inline u64 M = 1, NINV, R2;
+	static inline void set_mod(u64 m) {
+		assert((m & 1) && m < (1ULL << 62));
+		M = m; NINV = m;
+		for (int i = 0; i < 5; ++i) NINV *= 2 - m * NINV;
+		NINV = -NINV;
+		R2 = ((u128)-1 % m + 1) % m;
+	}
+	static inline u64 get_mod() { return M; }
+	static inline u64 reduce(u128 x) {
+		const u64 t = (x + (u128)((u64)x * NINV) * M) >> 64;
+		return t >= M? t - M: t;
+	}
+	static inline mint64 raw(u64 v) { mint64 ret; ret.v = v; return ret; }
+
+	u64 v;
+	mint64() {}
+	mint64(qe x): v(reduce((u128)((x %= (qe)M) < 0? x + M: x) * R2)) {}
+	inline u64 val() const { return reduce(v); }
+	inline mint64 pow(qe p) const {
+		mint64 ret = raw(reduce(R2)), x = *this;
+		for (; p; p >>= 1, x *= x) if (p & 1) ret *= x;
+		return ret;
+	}
+	inline mint64 inv() const { return pow(M - 2); }
+	inline mint64 operator+(const mint64 &t) const { return raw(v + t.v >= M? v + t.v - M: v + t.v); }
+	inline mint64 operator-(const mint64 &t) const { return raw(v < t.v? v - t.v + M: v - t.v); }
+	inline mint64 operator*(const mint64 &t) const { return raw(reduce((u128)v * t.v)); }
+	inline mint64 operator/(const mint64 &t) const { return *this * t.inv(); }
+	inline mint64 operator-() const { return raw(v? M - v: 0); }
+	inline void operator+=(const mint64 &t) { *this = *this + t; }
+	inline void operator-=(const mint64 &t) { *this = *this - t; }
+	inline void operator*=(const mint64 &t) { v = reduce((u128)v * t.v); }
+	inline void operator/=(const mint64 &t) { *this *= t.inv(); }
+	inline bool operator==(const mint64 &t) const { return v == t.v; }
+	inline bool operator!=(const mint64 &t) const { return v != t.v; }
+	friend inline std::ostream& operator<(std::ostream &out, const mint64 &t) { return out < t.val(); }
+	friend inline MO& operator<(MO &out, const mint64 &t) { return out < t.val(); }
+};
+template<class Tag> struct Q<mint64<Tag>> { inline void operator()(MI &r, mint64<Tag> &t) { t = mint64<Tag>(r.read<qe>()); } };
+
+// Arithmetic modulo the Mersenne prime 2^61 - 1; reducing is a mask, a shift and an add.
+struct mint61 {
+	typedef unsigned long long u64;
+	static constexpr u64 M = (1ULL << 61) - 1;
+	static inline u64 reduce(unsigned __int128 x) {
+		const u64 t = ((u64)x & M) + (u64)(x >> 61);
+		return t >= M? t - M: t;
+	}
+	static constexpr u64 get_mod() { return M; }
+	static inline mint61 raw(u64 v) { mint61 ret; ret.v = v; return ret; }
+
+	u64 v;
+	mint61() {}
+	mint61(qe x): v((x %= (qe)M) < 0? x + M: x) {}
+	inline u64 val() const { return v; }
+	inline mint61 pow(qe p) const {
+		mint61 ret = raw(1), x = *this;
+		for (; p; p >>= 1, x *= x) if (p & 1) ret *= x;
+		return ret;
+	}
+	inline mint61 inv() const { return pow(M - 2); }
+	inline mint61 operator+(const mint61 &t) const { return raw(v + t.v >= M? v + t.v - M: v + t.v); }
+	inline mint61 operator-(const mint61 &t) const { return raw(v < t.v? v - t.v + M: v - t.v); }
+	inline mint61 operator*(const mint61 &t) const { return raw(reduce((unsigned __int128)v * t.v)); }
+	inline mint61 operator/(const mint61 &t) const { return *this * t.inv(); }
+	inline mint61 operator-() const { return raw(v? M - v: 0); }
+	inline void operator+=(const mint61 &t) { *this = *this + t; }
+	inline void operator-=(const mint61 &t) { *this = *this - t; }
+	inline void operator*=(const mint61 &t) { v = reduce((unsigned __int128)v * t.v); }
+	inline void operator/=(const mint61 &t) { *this *= t.inv(); }
+	inline bool operator==(const mint61 &t) const { return v == t.v; }
+	inline bool operator!=(const mint61 &t) const { return v != t.v; }
+	friend inline std::ostream& operator<(std::ostream &out, const mint61 &t) { return out < t.v; }
+	friend inline MO& operator<(MO &out, const mint61 &t) { return out < t.v; }
+};
+template<> struct Q<mint61> { inline void operator()(MI &r, mint61 &t) { t = mint61(r.read<qe>()); } };
+
+// The modulus of each mint type, for code that is generic over them.
+template<class T> struct mint_mod { static inline qe get() { return T::get_mod(); } };
+template<> struct mint_mod<mint> { static inline qe get() { return mod; } };
+
+// Montgomery's trick: replaces every a[i] (all non-zero) by its inverse with one
+// inv() and 3(n - 1) multiplications, instead of one inv() per element.
+template<class T>
+inline void batch_inverse(T *a, size_t n) {
+	if (!n) return;
+	std::vector<T> pre(n);
+	pre[0] = a[0];
+	for (size_t i = 1; i < n; ++i) pre[i] = pre[i - 1] * a[i];
+	T x = pre[n - 1].inv();
+	for (size_t i = n - 1; i; --i) {
+		const T y = x * pre[i - 1];
+		x *= a[i];
+		a[i] = y;
+	}
+	a[0] = x;
+}
+template<class T> inline void batch_inverse(std::vector<T> &a) { batch_inverse(a.data(), a.size()); }
+
+// Factorials, inverse factorials and inverses of 1..n for any of the mint types
+// above. The tables grow (at least doubling) on demand, each growth costing O(n)
+// multiplications and a single inv(); n must stay below the modulus.
+template<class T = mint>
+struct combinatorics {
+	std::vector<T> f, fi, iv;
+	combinatorics(size_t n = 0): f(1, T(1)), fi(1, T(1)), iv(1, T(0)) { reserve(n); }
+	// makes 0..n available
+	void reserve(size_t n) {
+		const size_t old = f.size();
+		if (n < old) return;
+		// past the modulus every factorial is 0, so never grow beyond it
+		const size_t md = mint_mod<T>::get();
+		assert(n < md);
+		const size_t m = std::min(std::max(n + 1, old << 1), md);
+		f.resize(m); fi.resize(m); iv.resize(m);
+		for (size_t i = old; i < m; ++i) f[i] = f[i - 1] * T((qe)i);
+		fi[m - 1] = f[m - 1].inv();
+		for (size_t i = m - 1; i > old; --i) fi[i - 1] = fi[i] * T((qe)i);
+		for (size_t i = old; i < m; ++i) iv[i] = fi[i] * f[i - 1];
+	}
+	inline T fact(size_t n) { reserve(n); return f[n]; }
+	inline T inv_fact(size_t n) { reserve(n); return fi[n]; }
+	// 1 / n, n >= 1
+	inline T inv(size_t n) { reserve(n); return iv[n]; }
+	inline T C(qe n, qe k) {
+		if (k < 0 || k > n) return T(0);
+		reserve(n);
+		return f[n] * fi[k] * fi[n - k];
+	}
+	inline T A(qe n, qe k) {
+		if (k < 0 || k > n) return T(0);
+		reserve(n);
+		return f[n] * fi[n - k];
+	}
+	inline T catalan(qe n) { return n < 0? T(0): C(n << 1, n) * inv(n + 1); }
+};
+
+// How lazy_sum handles each mint type: W is the raw accumulator, prod the unreduced
+// product of two stored values, carry 2^(bits of W) modulo the modulus (added back
+// whenever the accumulator wraps), and finish turns a sum (any W, reduced or not)
+// back into a T.
+template<class T> struct lazy_traits;
+template<> struct lazy_traits<mint> {
+	typedef unsigned long long W;
+	static inline W prod(const mint &a, const mint &b) { return (W)a.v * b.v; }
+	static inline W carry() { return -(W)mod % mod; }
+	static inline W get_mod() { return mod; }
+	static inline mint finish(W s) { return (int)(s % mod); }
+};
+template<int Mod> struct lazy_traits<static_mint<Mod>> {
+	typedef unsigned long long W;
+	static inline W prod(const static_mint<Mod> &a, const static_mint<Mod> &b) { return (W)a.v * b.v; }
+	static inline W carry() { return -(W)Mod % Mod; }
+	static inline W get_mod() { return Mod; }
+	// the products carry R^2, one reduction takes them back to R
+	static inline static_mint<Mod> finish(W s) { return static_mint<Mod>::raw(static_mint<Mod>::reduce(s % Mod)); }
+};
+template<class Tag> struct lazy_traits<dynamic_mint<Tag>> {
+	typedef unsigned long long W;
+	static inline W prod(const dynamic_mint<Tag> &a, const dynamic_mint<Tag> &b) { return (W)a.v * b.v; }
+	static inline W carry() { return -(W)dynamic_mint<Tag>::get_mod() % dynamic_mint<Tag>::get_mod(); }
+	static inline W get_mod() { return dynamic_mint<Tag>::get_mod(); }
+	static inline dynamic_mint<Tag> finish(W s) { return dynamic_mint<Tag>::raw(s % dynamic_mint<Tag>::get_mod()); }
+};
+template<class Tag> struct lazy_traits<mint64<Tag>> {
+	typedef unsigned __int128 W;
+	static inline W prod(const mint64<Tag> &a, const mint64<Tag> &b) { return (W)a.v * b.v; }
+	static inline W carry() { return mint64<Tag>::R2; }
+	static inline W get_mod() { return mint64<Tag>::M; }
+	static inline mint64<Tag> finish(W s) { return mint64<Tag>::raw(mint64<Tag>::reduce(s % mint64<Tag>::M)); }
+};
+template<> struct lazy_traits<mint61> {
+	typedef unsigned __int128 W;
+	static inline W prod(const mint61 &a, const mint61 &b) { return (W)a.v * b.v; }
+	static inline W carry() { return 64; }
+	static inline W get_mod() { return mint61::M; }
+	static inline mint61 finish(W s) { return mint61::raw(mint61::reduce(s % mint61::M)); }
+};
+
+// Sums products a * b without reducing each one: the raw products are added into a
+// 64-bit (128-bit for mint64 / mint61) word, and only a wrap-around costs a fix-up.
+//   lazy_sum<mint> s; for (...) s.add(a[i], b[i]); mint r = s.get();
+template<class T = mint>
+struct lazy_sum {
+	typedef lazy_traits<T> tr;
+	typedef typename tr::W W;
+	W s = 0, c = tr::carry();
+	inline void add(const T &a, const T &b) {
+		const W p = tr::prod(a, b);
+		if ((s += p) < p) s += c;
+	}
+	// both sums may be close to 2^bits, so adding the carry back can wrap again
+	inline void add(const lazy_sum &t) { if ((s += t.s) < t.s && (s += c) < c) s += c; }
+	inline void clear() { s = 0; }
+	inline T get() const { return tr::finish(s); }
+};
+
+// sum of a[i] * b[i], with four independent accumulators
+template<class T>
+inline T dot(const T *a, const T *b, size_t n) {
+	lazy_sum<T> s0, s1, s2, s3;
+	size_t i = 0;
+	for (const size_t m = n & ~size_t(3); i < m; i += 4) {
+		s0.add(a[i], b[i]); s1.add(a[i + 1], b[i + 1]);
+		s2.add(a[i + 2], b[i + 2]); s3.add(a[i + 3], b[i + 3]);
+	}
+	for (; i < n; ++i) s0.add(a[i], b[i]);
+	s0.add(s1); s2.add(s3); s0.add(s2);
+	return s0.get();
+}
+template<class T>
+inline T dot(const std::vector<T> &a, const std::vector<T> &b) {
+	assert(a.size() == b.size());
+	return dot(a.data(), b.data(), a.size());
+}
 // coco: preserve_end
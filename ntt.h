@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "batch.h"
+
+// coco: preserve_begin
+// Number-theoretic transform modulo an NTT-friendly prime Mod (Mod - 1 divisible by
+// the transform size). The forward transform is decimation-in-frequency and leaves
+// its output in bit-reversed order, the inverse one is decimation-in-time and takes
+// that order back, so no permutation pass is ever needed in between.
+template<int Mod>
+struct ntt {
+	typedef static_mint<Mod> mint_t;
+
+	// rt[k + j] = w_{2k}^j for every power of two k, irt holds the inverses
+	static inline std::vector<mint_t> rt, irt;
+
+	static int primitive_root() {
+		std::vector<int> ps;
+		int x = Mod - 1;
+		for (int p = 2; (qe)p * p <= x; ++p)
+			if (x % p == 0) { ps.push_back(p); while (x % p == 0) x /= p; }
+		if (x > 1) ps.push_back(x);
+		for (int g = 2; ; ++g)
+			if (std::all_of(ps.begin(), ps.end(), [g](int p) { return mint_t(g).pow((Mod - 1) / p) != mint_t(1); }))
+				return g;
+	}
+	static void prepare(size_t n) {
+		n = std::max<size_t>(n, 2);
+		if (rt.size() >= n) return;
+		assert((Mod - 1) % n == 0);
+		static const mint_t g = primitive_root();
+		size_t k = std::max<size_t>(rt.size(), 1) >> 1;
+		rt.resize(n); irt.resize(n);
+		if (!k) { rt[1] = irt[1] = 1; k = 1; }
+		for (; k < n >> 1; k <<= 1) {
+			const mint_t w = g.pow((Mod - 1) / (k << 2)), iw = w.inv();
+			for (size_t j = k << 1; j < k << 2; ++j) {
+				rt[j] = rt[j >> 1]; irt[j] = irt[j >> 1];
+				if (j & 1) { rt[j] *= w; irt[j] *= iw; }
+			}
+		}
+	}
+
+#ifdef __AVX2__
+	// Levels with len < 8 work inside single vectors: u and v are the two halves of
+	// every 2 * len block broadcast over the whole vector, and merge() picks the sums
+	// for the lower and the differences for the upper halves.
+	static inline void split(__m256i x, size_t len, __m256i &u, __m256i &v) {
+		if (len == 4) { u = _mm256_permute2x128_si256(x, x, 0x00); v = _mm256_permute2x128_si256(x, x, 0x11); }
+		else if (len == 2) { u = _mm256_shuffle_epi32(x, 0x44); v = _mm256_shuffle_epi32(x, 0xee); }
+		else { u = _mm256_shuffle_epi32(x, 0xa0); v = _mm256_shuffle_epi32(x, 0xf5); }
+	}
+	static inline __m256i merge(__m256i s, __m256i d, size_t len) {
+		return len == 4? _mm256_blend_epi32(s, d, 0xf0): len == 2? _mm256_blend_epi32(s, d, 0xcc): _mm256_blend_epi32(s, d, 0xaa);
+	}
+	static inline __m256i twiddles(const std::vector<mint_t> &w, size_t len) {
+		alignas(32) unsigned t[8];
+		for (int k = 0; k < 8; ++k) t[k] = w[len + (k & (len - 1))].v;
+		return _mm256_load_si256(reinterpret_cast<const __m256i*>(t));
+	}
+#endif
+
+	// in-place, n must be a power of two
+	static void forward(mint_t *a, size_t n) {
+		prepare(n);
+		for (size_t len = n >> 1; len; len >>= 1) {
+#ifdef __AVX2__
+			const batch_detail::avx2 c(Mod);
+			if (len < 8 && n >= 8) {
+				const __m256i w = twiddles(rt, len);
+				for (size_t i = 0; i < n; i += 8) {
+					__m256i u, v; split(c.load(a + i), len, u, v);
+					c.store(a + i, merge(c.add(u, v), c.mul(c.sub(u, v), w), len));
+				}
+				continue;
+			}
+#endif
+			for (size_t i = 0; i < n; i += len << 1) {
+				size_t j = 0;
+#ifdef __AVX2__
+				for (; j + 8 <= len; j += 8) {
+					const __m256i u = c.load(a + i + j), v = c.load(a + i + j + len);
+					c.store(a + i + j, c.add(u, v));
+					c.store(a + i + j + len, c.mul(c.sub(u, v), c.load(rt.data() + len + j)));
+				}
+#endif
+				for (; j < len; ++j) {
+					const mint_t u = a[i + j], v = a[i + j + len];
+					a[i + j] = u + v;
+					a[i + j + len] = (u - v) * rt[len + j];
+				}
+			}
+		}
+	}
+	static void inverse(mint_t *a, size_t n) {
+		prepare(n);
+		for (size_t len = 1; len < n; len <<= 1) {
+#ifdef __AVX2__
+			const batch_detail::avx2 c(Mod);
+			if (len < 8 && n >= 8) {
+				const __m256i w = twiddles(irt, len);
+				for (size_t i = 0; i < n; i += 8) {
+					__m256i u, v; split(c.load(a + i), len, u, v);
+					v = c.mul(v, w);
+					c.store(a + i, merge(c.add(u, v), c.sub(u, v), len));
+				}
+				continue;
+			}
+#endif
+			for (size_t i = 0; i < n; i += len << 1) {
+				size_t j = 0;
+#ifdef __AVX2__
+				for (; j + 8 <= len; j += 8) {
+					const __m256i u = c.load(a + i + j), v = c.mul(c.load(a + i + j + len), c.load(irt.data() + len + j));
+					c.store(a + i + j, c.add(u, v));
+					c.store(a + i + j + len, c.sub(u, v));
+				}
+#endif
+				for (; j < len; ++j) {
+					const mint_t u = a[i + j], v = a[i + j + len] * irt[len + j];
+					a[i + j] = u + v;
+					a[i + j + len] = u - v;
+				}
+			}
+		}
+		const mint_t inv = mint_t((int)n).inv();
+		size_t i = 0;
+#ifdef __AVX2__
+		const batch_detail::avx2 c(Mod);
+		const __m256i k = _mm256_set1_epi32(inv.v);
+		for (; i + 8 <= n; i += 8) c.store(a + i, c.mul(c.load(a + i), k));
+#endif
+		for (; i < n; ++i) a[i] *= inv;
+	}
+
+	// the first min(limit, |a| + |b| - 1) coefficients of a * b
+	static std::vector<mint_t> convolve(std::vector<mint_t> a, std::vector<mint_t> b, size_t limit = -1) {
+		if (a.empty() || b.empty() || !limit) return {};
+		const size_t len = std::min(limit, a.size() + b.size() - 1);
+		if (a.size() > len) a.resize(len);
+		if (b.size() > len) b.resize(len);
+		if (std::min(a.size(), b.size()) <= 32) {
+			std::vector<mint_t> ret(len, 0);
+			if (a.size() < b.size()) a.swap(b);
+			for (size_t j = 0; j < b.size(); ++j) axpy(ret.data() + j, b[j], a.data(), std::min(a.size(), len - j));
+			return ret;
+		}
+		// terms past len never matter, so the inputs were cut to len before sizing the transform
+		size_t n = 2;
+		while (n < a.size() + b.size() - 1) n <<= 1;
+		a.resize(n, 0); b.resize(n, 0);
+		forward(a.data(), n); forward(b.data(), n);
+		mul_n(a.data(), a.data(), b.data(), n);
+		inverse(a.data(), n);
+		a.resize(len);
+		return a;
+	}
+};
+
+template<int Mod>
+inline std::vector<static_mint<Mod>> convolve(const std::vector<static_mint<Mod>> &a, const std::vector<static_mint<Mod>> &b, size_t limit = -1) {
+	return ntt<Mod>::convolve(a, b, limit);
+}
+
+// Any modulus: convolve modulo three NTT primes and combine them with Garner's algorithm.
+inline std::vector<mint> convolve(const std::vector<mint> &a, const std::vector<mint> &b, size_t limit = -1) {
+	static const int M1 = 754974721, M2 = 167772161, M3 = 469762049;
+	const auto run = [&](auto tag) {
+		typedef decltype(tag) mint_t;
+		std::vector<mint_t> x(a.size()), y(b.size());
+		for (size_t i = 0; i < a.size(); ++i) x[i] = mint_t(a[i].v);
+		for (size_t i = 0; i < b.size(); ++i) y[i] = mint_t(b[i].v);
+		return convolve(x, y, limit);
+	};
+	const auto c1 = run(static_mint<M1>(0));
+	const auto c2 = run(static_mint<M2>(0));
+	const auto c3 = run(static_mint<M3>(0));
+	const static_mint<M2> i1 = static_mint<M2>(M1).inv();
+	const static_mint<M3> i12 = (static_mint<M3>(M1) * static_mint<M3>(M2)).inv();
+	const qe m1 = M1 % mod, m12 = (qe)M1 * M2 % mod;
+	std::vector<mint> ret(c1.size());
+	for (size_t i = 0; i < ret.size(); ++i) {
+		const qe x1 = c1[i].val();
+		const qe x2 = ((c2[i] - static_mint<M2>((int)x1)) * i1).val();
+		const qe x3 = ((c3[i] - static_mint<M3>((qe)(x1 + x2 * M1))) * i12).val();
+		ret[i] = mint((qe)((x1 + x2 % mod * m1 + x3 % mod * m12) % mod));
+	}
+	return ret;
+}
+// coco: preserve_end
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "io.h"
+
+namespace mic {
+
+// Reads every whitespace-separated integer left in `f` using `threads` threads.
+// Regular files are mapped, anything else is read in chunks first. The input is
+// cut at whitespace, each thread counts the tokens of its piece, and then parses
+// them with MI::read_n straight into their final position in the result.
+template<class T = int>
+std::vector<T> parallel_read(FILE *f = stdin, unsigned threads = std::thread::hardware_concurrency()) {
+	static const size_t CHUNK = 1 << 20;
+
+	const char *begin = nullptr, *end = nullptr;
+	void *map = nullptr;
+	size_t map_size = 0;
+	std::vector<char> buf;
+#ifdef __linux__
+	struct stat st;
+	long offset;
+	if (!fstat(fileno(f), &st) && S_ISREG(st.st_mode) && (offset = ftell(f)) >= 0 && offset < st.st_size) {
+		void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fileno(f), 0);
+		if (p != MAP_FAILED) {
+			map = p; map_size = st.st_size;
+			begin = static_cast<const char*>(map) + offset;
+			end = static_cast<const char*>(map) + map_size;
+		}
+	}
+#endif
+	if (!map) {
+		for (size_t len = 0; ; ) {
+			buf.resize(len + CHUNK);
+			const size_t got = fread(buf.data() + len, 1, CHUNK, f);
+			len += got;
+			if (got < CHUNK) { buf.resize(len); break; }
+		}
+		begin = buf.data(); end = begin + buf.size();
+	}
+
+	const auto is_space = [](char c) { return static_cast<signed char>(c) <= ' '; };
+	if (!threads) threads = 1;
+	const size_t len = end - begin;
+	threads = std::max<size_t>(1, std::min<size_t>(threads, len / CHUNK));
+	std::vector<const char*> cut(threads + 1, end);
+	cut[0] = begin;
+	for (unsigned i = 1; i < threads; ++i) {
+		const char *p = std::max(cut[i - 1], begin + len / threads * i);
+		while (p != end && !is_space(*p)) ++p;
+		cut[i] = p;
+	}
+
+	const auto run = [threads](auto &&func) {
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads; ++i) pool.emplace_back(func, i);
+		func(0);
+		for (auto &t : pool) t.join();
+	};
+	std::vector<size_t> pos(threads + 1);
+	run([&](unsigned i) {
+		const char *p = cut[i], *e = cut[i + 1];
+		size_t cnt = 0;
+		bool last = false;
+#ifdef __SSE2__
+		// bit j of m tells whether p[j] belongs to a token; count the 0 -> 1 edges
+		for (unsigned prev = 0; e - p >= 16; p += 16) {
+			const unsigned m = _mm_movemask_epi8(_mm_cmpgt_epi8(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8(' ')));
+			cnt += __builtin_popcount(m & ~((m << 1) | prev));
+			prev = m >> 15; last = prev;
+		}
+#endif
+		for (; p != e; ++p) {
+			const bool cur = !is_space(*p);
+			cnt += !last & cur;
+			last = cur;
+		}
+		pos[i + 1] = cnt;
+	});
+	for (unsigned i = 0; i < threads; ++i) pos[i + 1] += pos[i];
+
+	std::vector<T> ret(pos[threads]);
+	run([&](unsigned i) {
+#if defined(MIVIK) && !defined(__linux__)
+		// MI can't parse a memory range here
+		T *out = ret.data() + pos[i];
+		for (const char *p = cut[i], *e = cut[i + 1]; ; ) {
+			while (p != e && is_space(*p)) ++p;
+			if (p == e) break;
+			p = std::from_chars(p, e, *out++).ptr;
+			while (p != e && !is_space(*p)) ++p;
+		}
+#else
+		MI in(cut[i], cut[i + 1]);
+		in.read_n(ret.data() + pos[i], pos[i + 1] - pos[i]);
+#endif
+	});
+#ifdef __linux__
+	if (map) munmap(map, map_size);
+#endif
+	return ret;
+}
+
+} // namespace mic
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "ntt.h"
+
+// coco: preserve_begin
+// Formal power series modulo x^n over static_mint<Mod> (Mod NTT-friendly), all
+// computed by Newton iteration in O(n log n). The scratch buffers below are grown
+// once and reused by every doubling step, so keep one fps object around (or use the
+// poly_* wrappers, which share one per Mod) instead of making one per call.
+template<int Mod>
+struct fps {
+	typedef static_mint<Mod> mint_t;
+	typedef std::vector<mint_t> poly;
+	typedef ntt<Mod> tr;
+
+	static size_t ceil2(size_t n) { size_t m = 1; while (m < n) m <<= 1; return m; }
+
+	// the first n coefficients of 1 / a, a[0] != 0
+	poly inv(const poly &a, size_t n) { poly ret; inv_to(a, n, ret); return ret; }
+	// the first n coefficients of ln(a), a[0] == 1
+	poly log(const poly &a, size_t n) { poly ret; log_to(a, n, ret); return ret; }
+	// the first n coefficients of exp(a), a[0] == 0
+	poly exp(const poly &a, size_t n) { poly ret; exp_to(a, n, ret); return ret; }
+	// the first n coefficients of a^k
+	poly pow(const poly &a, qe k, size_t n) {
+		size_t z = 0;
+		while (z < a.size() && a[z] == mint_t(0)) ++z;
+		if (!k) { poly ret(n, 0); if (n) ret[0] = 1; return ret; }
+		if (z == a.size() || z >= (n + k - 1) / k) return poly(n, 0);
+		const size_t shift = z * k, len = n - shift;
+		const mint_t c = a[z], ic = c.inv(), kk = mint_t(k);
+		poly b(a.begin() + z, a.begin() + std::min(a.size(), z + len));
+		for (auto &x : b) x *= ic;
+		poly l; log_to(b, len, l);
+		for (auto &x : l) x *= kk;
+		exp_to(l, len, b);
+		const mint_t ck = c.pow(k);
+		poly ret(n, 0);
+		for (size_t i = 0; i < len; ++i) ret[shift + i] = b[i] * ck;
+		return ret;
+	}
+	// the first n coefficients of a square root of a, empty if there is none
+	poly sqrt(const poly &a, size_t n) {
+		size_t z = 0;
+		while (z < a.size() && a[z] == mint_t(0)) ++z;
+		if (z == a.size() || z / 2 >= n) return poly(n, 0);
+		mint_t r;
+		if ((z & 1) || !sqrt_mod(a[z], r)) return {};
+		const size_t shift = z / 2, len = n - shift;
+		const poly b(a.begin() + z, a.begin() + std::min(a.size(), z + len));
+		const mint_t inv2 = mint_t(2).inv();
+		poly s(1, r);
+		s.reserve(ceil2(len));
+		for (size_t m = 1; m < len; m <<= 1) {
+			const size_t k = m << 1;
+			inv_to(s, k, t);
+			mul_to(b, t, k, l);
+			s.resize(k, 0);
+			for (size_t i = 0; i < k; ++i) s[i] = (s[i] + l[i]) * inv2;
+		}
+		poly ret(n, 0);
+		for (size_t i = 0; i < len; ++i) ret[shift + i] = s[i];
+		return ret;
+	}
+
+	// x^2 = a, Tonelli-Shanks
+	static bool sqrt_mod(mint_t a, mint_t &x) {
+		if (a == mint_t(0)) { x = 0; return true; }
+		if (a.pow((Mod - 1) >> 1) != mint_t(1)) return false;
+		int s = 0, q = Mod - 1;
+		while (!(q & 1)) q >>= 1, ++s;
+		mint_t z = 2;
+		while (z.pow((Mod - 1) >> 1) == mint_t(1)) z += 1;
+		mint_t c = z.pow(q), t = a.pow(q);
+		x = a.pow((q + 1) >> 1);
+		for (int m = s; t != mint_t(1); ) {
+			int i = 0;
+			for (mint_t u = t; u != mint_t(1); u *= u) ++i;
+			mint_t b = c;
+			for (int j = 0; j < m - i - 1; ++j) b *= b;
+			x *= b; c = b * b; t *= c; m = i;
+		}
+		if (x.val() > Mod - x.val()) x = -x;
+		return true;
+	}
+
+private:
+	poly f, g, p, q, t, l, iv;
+
+	// out = the first n coefficients of a * b; out may alias a or b
+	void mul_to(const poly &a, const poly &b, size_t n, poly &out) {
+		const size_t na = std::min(a.size(), n), nb = std::min(b.size(), n);
+		if (!na || !nb) { out.assign(n, 0); return; }
+		const size_t m = ceil2(na + nb - 1);
+		p.assign(m, 0); std::copy(a.begin(), a.begin() + na, p.begin());
+		q.assign(m, 0); std::copy(b.begin(), b.begin() + nb, q.begin());
+		tr::forward(p.data(), m); tr::forward(q.data(), m);
+		mul_n(p.data(), p.data(), q.data(), m);
+		tr::inverse(p.data(), m);
+		out.assign(n, 0);
+		std::copy(p.begin(), p.begin() + std::min(n, m), out.begin());
+	}
+	// b <- b (2 - a b) on length-2m cyclic transforms: the low half of a b is known
+	// to be 1, so only its high half is fed into the second product
+	void inv_to(const poly &a, size_t n, poly &b) {
+		assert(!a.empty() && a[0] != mint_t(0));
+		b.assign(1, a[0].inv());
+		b.reserve(ceil2(n));
+		for (size_t m = 1; m < n; m <<= 1) {
+			const size_t k = m << 1;
+			f.assign(k, 0); std::copy(a.begin(), a.begin() + std::min(a.size(), k), f.begin());
+			g.assign(k, 0); std::copy(b.begin(), b.end(), g.begin());
+			tr::forward(f.data(), k); tr::forward(g.data(), k);
+			mul_n(f.data(), f.data(), g.data(), k);
+			tr::inverse(f.data(), k);
+			std::fill(f.begin(), f.begin() + m, mint_t(0));
+			tr::forward(f.data(), k);
+			mul_n(f.data(), f.data(), g.data(), k);
+			tr::inverse(f.data(), k);
+			b.resize(k);
+			for (size_t i = m; i < k; ++i) b[i] = -f[i];
+		}
+		b.resize(n);
+	}
+	// ln(a) = integral of a' / a
+	void log_to(const poly &a, size_t n, poly &out) {
+		assert(!a.empty() && a[0] == mint_t(1));
+		if (!n) { out.clear(); return; }
+		if (iv.size() < n + 1) {
+			size_t i = std::max<size_t>(iv.size(), 2);
+			iv.resize(n + 1);
+			iv[1] = 1;
+			for (; i <= n; ++i) iv[i] = -mint_t(Mod / (int)i) * iv[Mod % i];
+		}
+		inv_to(a, n, t);
+		poly &da = out;
+		da.assign(n, 0);
+		for (size_t i = 1; i < std::min(a.size(), n); ++i) da[i - 1] = a[i] * mint_t((int)i);
+		mul_to(da, t, n, da);
+		for (size_t i = n - 1; i; --i) da[i] = da[i - 1] * iv[i];
+		da[0] = 0;
+	}
+	// b <- b (1 - ln b + a)
+	void exp_to(const poly &a, size_t n, poly &b) {
+		assert(a.empty() || a[0] == mint_t(0));
+		b.assign(1, 1);
+		b.reserve(ceil2(n));
+		for (size_t m = 1; m < n; m <<= 1) {
+			const size_t k = m << 1;
+			log_to(b, k, l);
+			for (size_t i = 0; i < k; ++i) l[i] = (i < a.size()? a[i]: mint_t(0)) - l[i];
+			l[0] += 1;
+			mul_to(b, l, k, b);
+		}
+		b.resize(n);
+	}
+};
+
+template<int Mod> inline fps<Mod>& fps_instance() { static fps<Mod> f; return f; }
+template<int Mod> inline std::vector<static_mint<Mod>> poly_inv(const std::vector<static_mint<Mod>> &a, size_t n) { return fps_instance<Mod>().inv(a, n); }
+template<int Mod> inline std::vector<static_mint<Mod>> poly_log(const std::vector<static_mint<Mod>> &a, size_t n) { return fps_instance<Mod>().log(a, n); }
+template<int Mod> inline std::vector<static_mint<Mod>> poly_exp(const std::vector<static_mint<Mod>> &a, size_t n) { return fps_instance<Mod>().exp(a, n); }
+template<int Mod> inline std::vector<static_mint<Mod>> poly_pow(const std::vector<static_mint<Mod>> &a, qe k, size_t n) { return fps_instance<Mod>().pow(a, k, n); }
+template<int Mod> inline std::vector<static_mint<Mod>> poly_sqrt(const std::vector<static_mint<Mod>> &a, size_t n) { return fps_instance<Mod>().sqrt(a, n); }
+// coco: preserve_end